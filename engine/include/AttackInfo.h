@@ -0,0 +1,36 @@
+#ifndef ATTACKINFO_H
+#define ATTACKINFO_H
+
+#include "typedef.h"
+
+/*
+The attacks of a position, computed lazily at most once per node and shared by the evaluation, the check detection,
+the castling rules and the move generator. The attack maps of each side and the check and pin masks are filled separately,
+each tagged with the hash key of the position they were computed for, so a node only pays for the parts it uses.
+*/
+struct AttackInfo
+{
+    // Hash keys of the positions the attack maps of each side and the check and pin masks belong to
+    U64 attacksKey[2] = {0ULL, 0ULL};
+    U64 checksKey = 0ULL;
+
+    // Squares attacked by every piece type and by each side, with every piece blocking the sliding pieces
+    U64 pieceAttacks[12];
+    U64 sideAttacks[2];
+
+    // Number of squares attacked by the bishops and queens of each type, summed over the pieces and left unset for the other types
+    int mobility[12];
+
+    // Pieces giving check and the squares on which the pieces other than the king resolve it
+    U64 checkers;
+    U64 evasionMask;
+
+    // Squares the king of the side to move may not step on, including those behind it on the line of a sliding checker
+    U64 kingDanger;
+
+    // Pieces pinned to the king of the side to move, each with the line it may still move along
+    U64 pinned;
+    U64 pinRays[64];
+};
+
+#endif
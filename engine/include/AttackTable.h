@@ -1,47 +1,136 @@
 #ifndef ATTACK_TABLE_H
 #define ATTACK_TABLE_H
 
+#include "bitboard_operations.h"
+#include "engine_exceptions.h"
+#include "magic_numbers.h"
+#include "masks.h"
 #include "typedef.h"
+#include "const.h"
+#include "enum.h"
+
+/*
+The sliding piece attacks come from the magic tables, or from the PEXT tables on x86-64 CPUs with fast BMI2.
+Building with KOGGE_STONE_SLIDERS (make SLIDERS=kogge-stone) computes them with occluded fills instead and leaves both tables out.
+*/
+#if defined(__x86_64__) && !defined(KOGGE_STONE_SLIDERS)
+#define PEXT_SLIDERS
+#endif
 
 class AttackTable
 {
 
 private:
-    U64 pawnAttacks[2][64];
-    U64 knightAttacks[64];
-    U64 kingAttacks[64];
-
-    // The maximum number of relevant bits for a bishop is 9, so the number of possible occupancy combinatons is 2^9 = 512
-    U64 bishopAttacks[64][512];
+    U64 pawnAttacks[2][64] = {};
+    U64 knightAttacks[64] = {};
+    U64 kingAttacks[64] = {};
 
-    // The maximum number of relevant bits for a bishop is 11, so the number of possible occupancy combinations is 2^11 = 4096
-    U64 rookAttacks[64][4096];
+#ifndef KOGGE_STONE_SLIDERS
+    U64 bishopMasks[64] = {};
+    U64 rookMasks[64] = {};
 
-    U64 bishopMasks[64];
-    U64 rookMasks[64];
-    U64 bishopMagics[64] = {0};
-    U64 rookMagics[64] = {0};
+    /*
+    Attacks of every square indexed by the magic hash of the occupancy under the mask. A square only takes the 2^relevant bits
+    entries its magic number indexes, packed one square after another from its offset, the bishops first and then the rooks.
+    */
+    U64 magicAttacks[SLIDER_TABLE_SIZE] = {};
+    int bishopOffsets[64] = {};
+    int rookOffsets[64] = {};
 
-    // Initialise magic numbers
-    void initialiseMagicNumbers();
+#ifdef PEXT_SLIDERS
+    // Attacks of every square indexed by the parallel bit extract of the occupancy under the mask, at the same offsets
+    U64 pextAttacks[SLIDER_TABLE_SIZE] = {};
+#endif
+#endif
 
     // Initialise leaping piece attack tables
-    void initialiseLeapingPieceTables();
+    constexpr void initialiseLeapingPieceTables()
+    {
+        // Loop over the squares
+        for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+        {
 
-    // Initialise sliding piece attack tables
-    void initialiseSlidingPieceTables(bool fBishop);
+            // Initialise leaping piece attacks
+            pawnAttacks[white][squareIndex] = maskPawnAttacks(white, squareIndex);
+            pawnAttacks[black][squareIndex] = maskPawnAttacks(black, squareIndex);
+            knightAttacks[squareIndex] = maskKnightAttacks(squareIndex);
+            kingAttacks[squareIndex] = maskKingAttacks(squareIndex);
+        }
+    }
 
-public:
-    // Class constructor to initialise magic numbers and piece attacks
-    AttackTable()
+#ifndef KOGGE_STONE_SLIDERS
+    /*
+    Initialise sliding piece attack tables, where a magic number mapping two occupancies with different attacks to one index fails the compilation.
+    The occupancy index deposits its bits onto the mask from the least significant one up, so it is exactly what PEXT extracts back
+    from the occupancy, and the PEXT table is filled at the occupancy index.
+    */
+    constexpr void initialiseSlidingPieceTables(bool fBishop)
     {
+        // The bishops take the start of the packed tables and the rooks follow them
+        int offset = fBishop ? 0 : SLIDER_BISHOP_ENTRIES;
+
+        // Loop over the squares
+        for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+        {
+
+            // Fill the arrays of masks to fetch attacks later
+            bishopMasks[squareIndex] = maskBishopAttacks(squareIndex);
+            rookMasks[squareIndex] = maskRookAttacks(squareIndex);
+
+            // Assign the attack mask
+            U64 attackMask = fBishop ? bishopMasks[squareIndex] : rookMasks[squareIndex];
+
+            int relevantBits = getPopulationCount(attackMask);
+            int maxOccupancyIndex = 1 << relevantBits;
+
+            (fBishop ? bishopOffsets : rookOffsets)[squareIndex] = offset;
+
+            // Loop over the occupancy indicies
+            for (int occupancyIndex = 0; occupancyIndex < maxOccupancyIndex; occupancyIndex++)
+            {
+
+                // Get an occupancy bitboard from the current occupancy index
+                U64 occupancy = getOccupancyFromIndex(occupancyIndex, relevantBits, attackMask);
+
+                // Generate a magic index, which stays below 2^relevant bits, and the attacks, which a slider always has, so a filled entry is a collision
+                int magicIndex = fBishop ? (int)((occupancy * BISHOP_MAGIC_NUMBERS[squareIndex]) >> (64 - BISHOP_RELEVANT_BITS[squareIndex]))
+                                         : (int)((occupancy * ROOK_MAGIC_NUMBERS[squareIndex]) >> (64 - ROOK_RELEVANT_BITS[squareIndex]));
+                U64 &entry = magicAttacks[offset + magicIndex];
+                U64 attacks = fBishop ? generateBishopAttacks(squareIndex, occupancy) : generateRookAttacks(squareIndex, occupancy);
 
-        initialiseMagicNumbers();
+                if (entry && entry != attacks)
+                {
+                    throw InvalidMagicNumberException();
+                }
+
+                entry = attacks;
+#ifdef PEXT_SLIDERS
+                pextAttacks[offset + occupancyIndex] = attacks;
+#endif
+            }
+
+            offset += maxOccupancyIndex;
+        }
+    }
+#endif
+
+public:
+    // Class constructor to fill the piece attacks, indexed by the built-in magic numbers for the sliding pieces, run at compile time for the global table
+    constexpr AttackTable()
+    {
         initialiseLeapingPieceTables();
+#ifndef KOGGE_STONE_SLIDERS
         initialiseSlidingPieceTables(true);
         initialiseSlidingPieceTables(false);
+#endif
     }
 
+    // Select the sliding piece attack backend for every attack table, returning false if the CPU cannot run it
+    static bool setSliderBackend(int backend);
+
+    // Get the sliding piece attack backend in use, PEXT by default where the CPU extracts bits fast, magic otherwise, and Kogge-Stone if built with it
+    static int getSliderBackend();
+
     // Get piece attacks
     U64 getPawnAttacks(uint color, int squareIndex) const;
     U64 getKnightAttacks(int squareIndex) const;
@@ -49,6 +138,20 @@ public:
     U64 getBishopAttacks(int squareIndex, U64 occupancy) const;
     U64 getRookAttacks(int squareIndex, U64 occupancy) const;
     U64 getQueenAttacks(int squareIndex, U64 occupancy) const;
+
+    // Get the squares attacked by all of the given pawns or knights at once
+    U64 getPawnSetAttacks(uint color, U64 pawns) const;
+    U64 getKnightSetAttacks(U64 knights) const;
+
+    // Get the squares attacked by all of the given bishops or rooks at once, which the Kogge-Stone fills cover in one pass
+    U64 getBishopSetAttacks(U64 bishops, U64 occupancy) const;
+    U64 getRookSetAttacks(U64 rooks, U64 occupancy) const;
+
+    // Get the attacks of the given piece, white or black, from the square
+    U64 getPieceAttacks(int piece, int squareIndex, U64 occupancy) const;
+
+    // Get the squares strictly between two squares sharing a rank, file or diagonal
+    U64 getBetweenSquares(int squareIndex1, int squareIndex2) const;
 };
 
 #endif
\ No newline at end of file
@@ -2,10 +2,16 @@
 #define BOARD_H
 
 #include <string>
+#include <cstdint>
 
 #include "AttackTable.h"
-#include "TranspositionNode.h"
+#include "TranspositionTable.h"
+#include "EvaluationCache.h"
+#include "PawnHashTable.h"
+#include "AttackInfo.h"
+#include "NeuralNetwork.h"
 #include "MoveList.h"
+#include "UndoInfo.h"
 #include "typedef.h"
 #include "const.h"
 #include "enum.h"
@@ -18,11 +24,32 @@ private:
     U64 bitboards[12];
     U64 occupancies[3];
 
+    // Mailbox of the piece on every square, or NO_PIECE, kept in sync with the bitboards and one cache line in size
+    int8_t pieceOn[64];
+
     // State variables
     int sideToMove = NO_SIDE_TO_MOVE;
     int enPassantSquareIndex = NO_SQUARE_INDEX;
     int canCastle = 0;
-    U64 hashKey;
+    U64 hashKey = 0ULL;
+
+    // Zobrist key of the pawns alone, indexing the pawn hash table
+    U64 pawnKey = 0ULL;
+
+    // Pawn hash table of the searching thread, the pawn structure is evaluated from scratch without one
+    PawnHashTable *pPawnTable = nullptr;
+
+    // Attack info of the last plies, indexed by the number of moves made modulo ATTACK_INFO_PLIES
+    AttackInfo attackInfos[ATTACK_INFO_PLIES];
+    int attackInfoPly = 0;
+
+    // Material plus positional scores for the opening and the endgame and the game score, updated by every move
+    int pieceSquareScore[2] = {0, 0};
+    int gameScore = 0;
+
+    // Neural network evaluating the position in place of the hand-crafted evaluation, and its first layer outputs, updated by every move while it is set
+    const NeuralNetwork *pNetwork = nullptr;
+    NNUEAccumulator accumulator;
 
     // Clear the board
     void resetBitboards();
@@ -33,9 +60,64 @@ private:
     // Populate occupancies from the board state
     void populateOccupancies();
 
+    // Add the piece on the square to the evaluation accumulators
+    void addPieceScore(int piece, int squareIndex);
+
+    // Remove the piece on the square from the evaluation accumulators
+    void removePieceScore(int piece, int squareIndex);
+
+    // Calculate the material plus positional scores for the opening and the endgame from scratch
+    void calculatePieceSquareScore(int *scores);
+
+    // Calculate the doubled, isolated and passed pawn scores from scratch, collecting the passed pawns of both sides
+    void evaluatePawns(int *scores, U64 *passedPawns);
+
+    // Add the doubled, isolated and passed pawn scores of the given color to the scores of white, collecting its passed pawns
+    template <int Color>
+    void evaluatePawns(int *scores, U64 &passedPawns);
+
+    // Add the mobility, open file and king shield scores of the pieces of the given color to the scores of white
+    template <int Color>
+    void evaluatePieces(const AttackInfo &info, U64 pawnFiles, int *scores, int &score);
+
+    // Apply the pieces added and removed by the move of the side to move to the network accumulator, or take them back when unmaking it
+    void updateAccumulator(int move, int capturedPiece, bool fUnmake);
+
+#ifdef DEBUG_BUILD
+    // Check the incrementally updated occupancies against a full rebuild from the piece bitboards
+    void verifyOccupancies();
+
+    // Check the incrementally updated evaluation accumulators against a full recalculation
+    void verifyEvaluationAccumulators();
+
+    // Check the cached attack info used by the move generation against a fresh computation
+    void verifyAttackInfo(const AttackInfo &info);
+#endif
+
     void generateHash();
 
-    bool isSquareAttacked(int squareIndex, int sideToMove);
+    // Get the pieces of the given side attacking the square, with the given occupancy blocking the sliding pieces
+    U64 getAttackers(int squareIndex, int side, U64 occupancy);
+
+    // Fill the attack maps of the given side in the attack info
+    void computeAttacks(AttackInfo &info, int side);
+
+    // Fill the checkers, evasion mask, king danger squares and pinned pieces of the attack info from the attack maps of the side not to move
+    void computeCheckAndPinMasks(AttackInfo &info);
+
+    // Get the attack info slot of the current position
+    inline AttackInfo &getAttackInfoSlot() { return attackInfos[attackInfoPly & (ATTACK_INFO_PLIES - 1)]; }
+
+    // Check if the en passant capture leaves the king safe
+    bool isEnPassantLegal(int startSquareIndex, int kingSquareIndex);
+
+    // Generate the moves of a piece type of the side to move onto the target squares, a pinned piece only moving along its pin
+    template <int Piece>
+    void generatePieceMoves(MoveList &output, U64 targets, const AttackInfo &info);
+
+    // Generate the legal moves of the given type for the side to move, with its color fixed at compile time
+    template <int Color, int GenType>
+    void generate(MoveList &output);
 
 public:
     // Default constructor
@@ -51,46 +133,111 @@ public:
     // Find the heuristic value of the position
     int staticEvaluate();
 
+    // Evaluate the position with the neural network if one is set and with the hand-crafted evaluation otherwise
+    int evaluate();
+
+    // Look the static evaluation up in the evaluation cache, evaluating and storing it on a miss, fHit is set if it was found
+    int readEvaluation(bool &fHit);
+
     // Print the state of the board
     void printState();
 
-    // Generate the list of all pseudo-legal moves in a position
-    MoveList generateMoves();
+    /*
+    Generate the list of the legal moves of the given type in a position:
+    captures with queen promotions, the remaining quiet moves, or check evasions, which are all moves when not in check
+    */
+    MoveList generateMoves(int moveType = allMoves);
+
+    // Check if the move is a legal move of the position, without generating the moves
+    bool isLegalMove(int move);
+
+    // Make a legal move, switching the side to move and saving what unmakeMove needs into the undo record
+    void makeMove(int move, UndoInfo &undo);
+
+    // Take back the move, restoring the position saved in the undo record by makeMove
+    void unmakeMove(int move, const UndoInfo &undo);
+
+    // Pass the turn without moving, saving the en passant square and the hash key into the undo record
+    void makeNullMove(UndoInfo &undo);
 
-    int makeMove(int move);
+    // Take back the null move
+    void unmakeNullMove(const UndoInfo &undo);
 
-    // Calculate the game score
+    // Calculate the game score from scratch
     int calculateGameScore();
 
     // Load the board from the FEN string
     void loadFenString(const std::string &fenString);
 
-    // Load a move string in FEN notation
-    void loadMoveString(const std::string &moveString);
+    // Load a move string in FEN notation, returning true if the move was made
+    bool loadMoveString(const std::string &moveString);
 
-    // Write a hash entry into the transposition table
-    void writeHashEntry(int score, int depth, int searchPly, int flag);
+    // Write a hash entry with the best move of the node into the transposition table
+    void writeHashEntry(int score, int depth, int searchPly, int flag, int move);
 
-    // Read the hash entry from the transposition table
-    int readHashEntry(int alpha, int beta, int depth, int searchPly);
-
-    void updateHashKey(int value);
+    // Read the hash entry from the transposition table, fHit is set if an entry for the position was found and hashMove receives its best move
+    int readHashEntry(int alpha, int beta, int depth, int searchPly, bool &fHit, int &hashMove);
 
     // Pass a turn to the opposite color
     void switchSideToMove();
 
     bool isKingInCheck();
 
-    // Reset the en passant square index
-    void resetEnPassantSquareIndex();
+    // Check if the square is attacked by the given side
+    bool isSquareAttacked(int squareIndex, int sideToMove);
 
     int getSideToMove();
 
     int getEnPassantSquareIndex();
 
-    int getHashKey();
+    U64 getHashKey();
+
+    U64 getPawnKey();
+
+    // Cache the pawn structure evaluation in the given table, or evaluate it from scratch if it is null
+    void setPawnHashTable(PawnHashTable *pTable);
+
+    // Evaluate with the given neural network, or with the hand-crafted evaluation if it is null, refreshing the accumulator
+    void setNetwork(const NeuralNetwork *pNetwork);
 
     U64 *getBitboards();
+
+    // Get the piece on the square, or NO_PIECE if the square is empty
+    inline int getPieceOnSquare(int squareIndex) const { return pieceOn[squareIndex]; }
+
+    // Get the attack info of the position with the attack maps of the given side, computing them on first use
+    inline const AttackInfo &getAttacks(int side)
+    {
+        AttackInfo &info = getAttackInfoSlot();
+
+        if (info.attacksKey[side] != hashKey)
+        {
+            computeAttacks(info, side);
+            info.attacksKey[side] = hashKey;
+        }
+
+        return info;
+    }
+
+    // Get the attack info of the position with the check and pin masks of the side to move, computing them on first use
+    inline const AttackInfo &getCheckAndPinMasks()
+    {
+        AttackInfo &info = getAttackInfoSlot();
+
+        // The castling rules read the attack maps of the side not to move, which a deeper ply may have taken over since the masks were filled
+        getAttacks(sideToMove ^ 1);
+
+        if (info.checksKey != hashKey)
+        {
+            computeCheckAndPinMasks(info);
+            info.checksKey = hashKey;
+        }
+
+        return info;
+    }
+
+    // Forget the attack info of the position, so the next query computes it again
+    void clearAttackInfo();
 };
 
 #endif
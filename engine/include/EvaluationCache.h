@@ -0,0 +1,75 @@
+#ifndef EVALUATION_CACHE_H
+#define EVALUATION_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "typedef.h"
+#include "const.h"
+
+/*
+Direct-mapped cache of static evaluations, indexed by the Zobrist hash key and shared by all of the search threads.
+Every entry is a single 64-bit word holding the low 48 bits of the hash key above the 16-bit score, so it is read
+and written atomically without locks and a torn entry can never be returned.
+It is kept apart from the transposition table so the evaluations survive its replacement policy.
+*/
+class EvaluationCache
+{
+
+private:
+    std::vector<std::atomic<U64>> entries;
+
+    // Generation of the network whose evaluations the entries hold, zero for the hand-crafted evaluation
+    U64 evaluatorGeneration = 0ULL;
+
+    // Get the entry of the hash key
+    inline std::atomic<U64> &getEntry(U64 hashKey)
+    {
+        // Multiply-shift maps the key onto the entries using its high bits, leaving the low bits to validate the entry
+        return entries[(U64)(((unsigned __int128)hashKey * entries.size()) >> 64)];
+    }
+
+public:
+    // The cache is allocated on demand, either by resize() or by the first search
+    EvaluationCache() {}
+
+    // Reallocate the cache with the given size in megabytes, which also empties it
+    void resize(int megabytes);
+
+    // Remove all of the entries
+    void clear();
+
+    // Allocate the default cache if none has been requested yet
+    void prepare();
+
+    // Empty the cache if its entries were computed by another evaluator than the one of the given generation
+    void setEvaluator(U64 generation);
+
+    // Find the score stored for the hash key, returning false if there is none
+    inline bool probe(U64 hashKey, int &score)
+    {
+        U64 entry = getEntry(hashKey).load(std::memory_order_relaxed);
+
+        score = (int16_t)(entry & 0xffff);
+
+        return (entry >> 16) == (hashKey & 0xffffffffffffULL);
+    }
+
+    // Store the score of the hash key, replacing whatever the entry held before
+    inline void store(U64 hashKey, int score)
+    {
+        // Scores that do not fit into the 16-bit field are simply not cached
+        if (score < INT16_MIN || score > INT16_MAX)
+        {
+            return;
+        }
+
+        getEntry(hashKey).store((hashKey << 16) | (uint16_t)score, std::memory_order_relaxed);
+    }
+
+    // Get the size of the cache in megabytes
+    int getMegabytes() const;
+};
+
+#endif
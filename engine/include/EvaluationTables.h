@@ -0,0 +1,83 @@
+#ifndef EVALUATION_TABLES_H
+#define EVALUATION_TABLES_H
+
+#include "masks.h"
+#include "typedef.h"
+#include "const.h"
+#include "enum.h"
+
+/*
+The masks and piece-square scores of the evaluation. The constructor is constexpr, so the global tables are generated
+at compile time into read-only data that every engine process maps from the binary instead of filling at startup.
+*/
+struct EvaluationTables
+{
+    U64 fileMasks[8] = {};
+    U64 rankMasks[8] = {};
+
+    // Files next to each file, and the squares in front of a pawn of each color on its own and the next files
+    U64 isolatedPawnMasks[8] = {};
+    U64 whitePassedPawnMasks[64] = {};
+    U64 blackPassedPawnMasks[64] = {};
+
+    // Material plus positional score of each piece on each square, from the perspective of white, for the opening and the endgame
+    int pieceSquareScore[2][12][64] = {};
+
+    // Contribution of each piece to the game score the game phase is derived from
+    int gamePhaseScore[12] = {};
+
+    // Generate the masks and piece-square tables used by the evaluation
+    constexpr EvaluationTables()
+    {
+        for (int rank = 0; rank < 8; rank++)
+        {
+            rankMasks[rank] |= generateMask(-1, rank);
+        }
+
+        for (int file = 0; file < 8; file++)
+        {
+            fileMasks[file] |= generateMask(file, -1);
+            isolatedPawnMasks[file] |= generateMask(file - 1, -1);
+            isolatedPawnMasks[file] |= generateMask(file + 1, -1);
+        }
+
+        for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+        {
+            int file = squareIndex % 8;
+            int rank = squareIndex / 8;
+
+            whitePassedPawnMasks[squareIndex] = isolatedPawnMasks[file] | generateMask(file, -1);
+            blackPassedPawnMasks[squareIndex] = whitePassedPawnMasks[squareIndex];
+
+            for (int i = 0; i < (8 - rank); i++)
+                whitePassedPawnMasks[squareIndex] &= ~rankMasks[7 - i];
+
+            for (int i = 0; i < rank + 1; i++)
+                blackPassedPawnMasks[squareIndex] &= ~rankMasks[i];
+        }
+
+        // Combine the material and positional scores of every piece on every square from the perspective of white
+        for (int phase = opening; phase <= endgame; phase++)
+        {
+            for (int currentPiece = whitePawn; currentPiece <= blackKing; currentPiece++)
+            {
+                for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+                {
+                    pieceSquareScore[phase][currentPiece][squareIndex] = MATERIAL_SCORE[phase][currentPiece] +
+                        ((currentPiece <= whiteKing) ? POSITIONAL_SCORE[phase][currentPiece % 6][squareIndex]
+                                                     : -POSITIONAL_SCORE[phase][currentPiece % 6][OPPOSITE_SIDE[squareIndex]]);
+                }
+            }
+        }
+
+        // The game score counts the opening material of both sides without the kings
+        for (int currentPiece = whitePawn; currentPiece <= blackKing; currentPiece++)
+        {
+            int material = MATERIAL_SCORE[opening][currentPiece];
+
+            gamePhaseScore[currentPiece] = (currentPiece % 6 == king) ? 0 : ((material < 0) ? -material : material);
+        }
+    }
+};
+
+#endif
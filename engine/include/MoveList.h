@@ -21,6 +21,12 @@ public:
                                     fCapture, fDoublePawnPush, fEnPassant, fCastling);
     }
 
+    // Add an encoded move to the moves array
+    inline void appendMove(int move)
+    {
+        moves[count++] = move;
+    }
+
     // Get the array of moves
     inline int *getMoves() { return moves; };
 
@@ -0,0 +1,304 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include <utility>
+
+#include "Board.h"
+#include "MoveList.h"
+#include "move_encoding.h"
+#include "bitboard_operations.h"
+#include "const.h"
+#include "enum.h"
+
+// Enumerate the stages of the move picker
+enum {stageHashMove, stageScoreCaptures, stageGoodCaptures, stageKillers, stageScoreQuiets, stageQuiets, stageBadCaptures, stageDone};
+
+/*
+Yield the moves of a node lazily, best first, in stages:
+the transposition table move, good captures, killers, quiet moves and finally bad captures.
+Every move is scored once into a parallel score array when its stage is reached and the best
+remaining move is found by selection, so a cutoff on an early move never pays for ordering the rest.
+The hash move is checked against the position on its own, so no move is generated before it has been searched:
+the captures are generated once the capture stages are reached and the quiet moves only once a stage needs them.
+*/
+class MovePicker
+{
+
+private:
+    Board &board;
+
+    MoveList moves;
+    int scores[256];
+
+    // Captures are partitioned to the front of the list, quiet moves follow
+    int numCaptures = 0;
+    bool fQuietsGenerated = false;
+    int captureIndex = 0;
+    int quietIndex = 0;
+    int killerIndex = 0;
+
+    int stage = stageHashMove;
+
+    int hashMove;
+    int killers[2];
+    const int (*historyMoves)[64];
+
+    // Generation type of the node, quiescence only walking the capture stages
+    int moveType;
+    bool fCapturesOnly;
+
+    // Generate the captures, or all of the evasions with the captures among them partitioned to the front
+    inline void generateCaptures()
+    {
+        if (moveType == evasionMoves)
+        {
+            // Evasions are few, so they are generated at once
+            moves = board.generateMoves(evasionMoves);
+            fQuietsGenerated = true;
+
+            int *moveArray = moves.getMoves();
+
+            for (int moveIndex = 0; moveIndex < moves.getCount(); moveIndex++)
+            {
+                if (isCapture(moveArray[moveIndex]) || getPromotedPiece(moveArray[moveIndex]) % 6 == queen)
+                {
+                    std::swap(moveArray[moveIndex], moveArray[numCaptures]);
+                    numCaptures++;
+                }
+            }
+        }
+        else
+        {
+            moves = board.generateMoves(captureMoves);
+            numCaptures = moves.getCount();
+        }
+
+        quietIndex = numCaptures;
+    }
+
+    // Append the quiet moves to the captures
+    inline void generateQuiets()
+    {
+        if (fQuietsGenerated)
+        {
+            return;
+        }
+
+        MoveList quiets = board.generateMoves(quietMoves);
+
+        for (int moveIndex = 0; moveIndex < quiets.getCount(); moveIndex++)
+        {
+            moves.appendMove(quiets.getMoves()[moveIndex]);
+        }
+
+        fQuietsGenerated = true;
+    }
+
+    // Check if the move is in the given part of the move list
+    inline bool isInList(int move, int startIndex, int endIndex)
+    {
+        for (int moveIndex = startIndex; moveIndex < endIndex; moveIndex++)
+        {
+            if (moves.getMoves()[moveIndex] == move)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Score a capture by MVV-LVA, lifting the captures that do not lose material above the threshold of good captures
+    inline int scoreCapture(int move)
+    {
+        int piece = getPiece(move);
+
+        // En passant captures and queen promotions find no piece on the target square and score as pawn captures
+        int capturedPiece = board.getPieceOnSquare(getTargetSquareIndex(move));
+        int victim = (capturedPiece == NO_PIECE) ? (piece < blackPawn ? blackPawn : whitePawn) : capturedPiece;
+
+        int score = MVV_LVA[piece][victim];
+
+        // A capture is only bad if a more valuable piece takes a piece the opponent defends
+        if (PIECE_VALUE[victim % 6] >= PIECE_VALUE[piece % 6] || !getBit(board.getAttacks(board.getSideToMove() ^ 1).sideAttacks[board.getSideToMove() ^ 1], getTargetSquareIndex(move)))
+        {
+            score += GOOD_CAPTURE_SCORE;
+        }
+
+        // Promotions also gain the promoted piece
+        if (getPromotedPiece(move))
+        {
+            score += PIECE_VALUE[getPromotedPiece(move) % 6];
+        }
+
+        return score;
+    }
+
+    // Move the best scored move of the range to its front and return its index
+    inline int selectBest(int startIndex, int endIndex)
+    {
+        int bestIndex = startIndex;
+
+        for (int moveIndex = startIndex + 1; moveIndex < endIndex; moveIndex++)
+        {
+            if (scores[moveIndex] > scores[bestIndex])
+            {
+                bestIndex = moveIndex;
+            }
+        }
+
+        std::swap(moves.getMoves()[startIndex], moves.getMoves()[bestIndex]);
+        std::swap(scores[startIndex], scores[bestIndex]);
+
+        return startIndex;
+    }
+
+public:
+    // Pick the moves of the given generation type: captureMoves in quiescence, evasionMoves in check and allMoves otherwise
+    MovePicker(Board &board, int hashMove, int killer1, int killer2, const int (*historyMoves)[64], int moveType)
+        : board(board), hashMove(hashMove), killers{killer1, killer2}, historyMoves(historyMoves), moveType(moveType), fCapturesOnly(moveType == captureMoves)
+    {
+        if (fCapturesOnly)
+        {
+            stage = stageScoreCaptures;
+        }
+    }
+
+    // Get the next move, or 0 once all of the moves have been yielded
+    int nextMove()
+    {
+        int *moveArray = moves.getMoves();
+
+        switch (stage)
+        {
+
+        case stageHashMove:
+
+            stage = stageScoreCaptures;
+
+            // Only yield the hash move if it is a legal move of this position, which a cutoff on it leaves without generating any move
+            if (hashMove && board.isLegalMove(hashMove))
+            {
+                return hashMove;
+            }
+
+            [[fallthrough]];
+
+        case stageScoreCaptures:
+
+            generateCaptures();
+
+            for (int moveIndex = 0; moveIndex < numCaptures; moveIndex++)
+            {
+                scores[moveIndex] = scoreCapture(moveArray[moveIndex]);
+            }
+
+            stage = stageGoodCaptures;
+
+            [[fallthrough]];
+
+        case stageGoodCaptures:
+
+            while (captureIndex < numCaptures)
+            {
+                int bestIndex = selectBest(captureIndex, numCaptures);
+
+                // The remaining captures are all bad, so they wait until after the quiet moves
+                if (scores[bestIndex] < GOOD_CAPTURE_SCORE)
+                {
+                    break;
+                }
+
+                captureIndex++;
+
+                if (moveArray[bestIndex] != hashMove)
+                {
+                    return moveArray[bestIndex];
+                }
+            }
+
+            stage = fCapturesOnly ? stageBadCaptures : stageKillers;
+
+            if (fCapturesOnly)
+            {
+                return nextMove();
+            }
+
+            [[fallthrough]];
+
+        case stageKillers:
+
+            generateQuiets();
+
+            while (killerIndex < 2)
+            {
+                int killer = killers[killerIndex++];
+
+                // A killer is only played if it is a quiet move of this position, and only once if both slots hold it
+                if (killer && killer != hashMove && (killerIndex == 1 || killer != killers[0]) && isInList(killer, numCaptures, moves.getCount()))
+                {
+                    return killer;
+                }
+            }
+
+            stage = stageScoreQuiets;
+
+            [[fallthrough]];
+
+        case stageScoreQuiets:
+
+            generateQuiets();
+
+            for (int moveIndex = numCaptures; moveIndex < moves.getCount(); moveIndex++)
+            {
+                scores[moveIndex] = historyMoves[getPiece(moveArray[moveIndex])][getTargetSquareIndex(moveArray[moveIndex])];
+            }
+
+            stage = stageQuiets;
+
+            [[fallthrough]];
+
+        case stageQuiets:
+
+            while (quietIndex < moves.getCount())
+            {
+                int bestIndex = selectBest(quietIndex, moves.getCount());
+                int move = moveArray[bestIndex];
+
+                quietIndex++;
+
+                if (move != hashMove && move != killers[0] && move != killers[1])
+                {
+                    return move;
+                }
+            }
+
+            stage = stageBadCaptures;
+
+            [[fallthrough]];
+
+        case stageBadCaptures:
+
+            while (captureIndex < numCaptures)
+            {
+                int bestIndex = selectBest(captureIndex, numCaptures);
+
+                captureIndex++;
+
+                if (moveArray[bestIndex] != hashMove)
+                {
+                    return moveArray[bestIndex];
+                }
+            }
+
+            stage = stageDone;
+
+            [[fallthrough]];
+
+        default:
+            return 0;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef NEURAL_NETWORK_H
+#define NEURAL_NETWORK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "typedef.h"
+#include "const.h"
+
+// First layer outputs of both perspectives, indexed by the color the features are seen from
+struct alignas(64) NNUEAccumulator
+{
+    int16_t values[2][NNUE_HIDDEN];
+};
+
+// Get the input feature of the piece on the square as seen from the perspective, which swaps the colors and mirrors the ranks for black
+inline int getFeatureIndex(int perspective, int piece, int squareIndex)
+{
+    return perspective ? ((piece + 6) % 12) * 64 + (squareIndex ^ 56) : piece * 64 + squareIndex;
+}
+
+/*
+Efficiently updatable neural network: the 768 piece-square inputs of each perspective feed NNUE_HIDDEN
+clipped ReLU neurons, and the neurons of the side to move and of the other side feed a single output.
+The first layer outputs are kept in an accumulator that a move only changes by a few weight rows.
+The weights are mapped straight from the network file, whose layout is a 64-byte header followed by the
+int16 feature weights, the int16 feature biases, the int16 output weights and the int32 output bias.
+*/
+class NeuralNetwork
+{
+
+private:
+    const int16_t *featureWeights = nullptr;
+    const int16_t *featureBiases = nullptr;
+    const int16_t *outputWeights = nullptr;
+    int32_t outputBias = 0;
+
+    // Mapping of the network file, or the copy of it read where memory mapping is unavailable
+    void *pMapping = nullptr;
+    size_t mappingSize = 0;
+    std::vector<char> fileContents;
+
+    // Number of the load that filled the weights, unique across all of the networks so results computed with other weights can be told apart
+    U64 generation = 0ULL;
+
+    // Release the mapping of the network file
+    void release();
+
+public:
+    NeuralNetwork() {}
+
+    ~NeuralNetwork();
+
+    NeuralNetwork(const NeuralNetwork &) = delete;
+    NeuralNetwork &operator=(const NeuralNetwork &) = delete;
+
+    // Map the weights of the network file into memory
+    void load(const std::string &path);
+
+    bool isLoaded() const;
+
+    // Get the number of the load that filled the weights, never zero once a file has been loaded
+    U64 getGeneration() const;
+
+    // Fill the accumulator from scratch with the features of the piece bitboards
+    void refreshAccumulator(NNUEAccumulator &accumulator, const U64 *bitboards) const;
+
+    // Add and remove the piece-square features of both perspectives in a single pass over the accumulator, every feature given as piece * 64 + square index
+    void updateAccumulator(NNUEAccumulator &accumulator, const int *addedFeatures, int numAdded, const int *removedFeatures, int numRemoved) const;
+
+    // Run the output layer on the accumulator and return the score from the perspective of the side to move
+    int evaluate(const NNUEAccumulator &accumulator, int sideToMove) const;
+};
+
+// Write a network that reproduces the material and piece-square scores of the hand-crafted evaluation, averaged over the game phases
+void writeBootstrapNetwork(const std::string &path);
+
+#endif
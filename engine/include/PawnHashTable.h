@@ -0,0 +1,58 @@
+#ifndef PAWN_HASH_TABLE_H
+#define PAWN_HASH_TABLE_H
+
+#include <vector>
+
+#include "typedef.h"
+#include "const.h"
+
+// The pawn structure scores and passed pawns of a pawn configuration, scores from the perspective of white
+struct PawnHashEntry
+{
+    U64 pawnKey = 0ULL;
+    U64 passedPawns[2] = {0ULL, 0ULL};
+    int score[2] = {0, 0};
+};
+
+/*
+Direct-mapped cache of the pawn structure evaluation, indexed by the pawn-only Zobrist key.
+Every search thread owns one, so the entries need no synchronisation.
+*/
+class PawnHashTable
+{
+
+private:
+    std::vector<PawnHashEntry> entries;
+
+    // Number of probes and the number of them that found their pawn configuration
+    U64 probes = 0ULL;
+    U64 hits = 0ULL;
+
+public:
+    PawnHashTable() : entries(PAWN_HASH_ENTRIES) {}
+
+    // Get the entry of the pawn key, fHit is set if it already holds the pawn configuration and otherwise the caller fills it
+    inline PawnHashEntry *probe(U64 pawnKey, bool &fHit)
+    {
+        PawnHashEntry *pEntry = &entries[pawnKey & (PAWN_HASH_ENTRIES - 1)];
+
+        fHit = pEntry->pawnKey == pawnKey;
+
+        probes++;
+        hits += fHit;
+
+        return pEntry;
+    }
+
+    // Forget all of the entries
+    void clear();
+
+    // Reset the probe and hit counters
+    void resetStatistics();
+
+    U64 getProbes() const;
+
+    U64 getHits() const;
+};
+
+#endif
@@ -4,8 +4,10 @@
 #include <iostream>
 #include <cstring>
 #include <chrono>
+#include <atomic>
 
 #include "Board.h"
+#include "MovePicker.h"
 #include "move_encoding.h"
 #include "bitboard_operations.h"
 #include "const.h"
@@ -14,11 +16,6 @@
 
 using std::cout, std::string;
 
-extern U64 repetitions[];
-extern int repetitionIndex;
-extern U64 ENPASSANT_KEYS[64];
-extern U64 SIDE_KEY;
-
 class Position {
 
     private:
@@ -30,12 +27,43 @@ class Position {
         int pvTable[MAX_SEARCH_DEPTH][MAX_SEARCH_DEPTH];
         int pvLength[MAX_SEARCH_DEPTH];
 
-        bool fPVScore = false;
-        bool fPVFollow = true;
-
         int bestMove;
         int searchPly;
 
+        // Hash keys of the positions played so far, used for the repetition detection
+        U64 repetitions[4096];
+        int repetitionIndex = 0;
+
+        // Number of nodes visited since the search variables were reset
+        U64 nodes = 0ULL;
+
+        // Number of transposition table probes and the number of them that found an entry
+        U64 hashProbes = 0ULL;
+        U64 hashHits = 0ULL;
+
+        // Number of evaluation cache probes and the number of them that found the position
+        U64 evalProbes = 0ULL;
+        U64 evalHits = 0ULL;
+
+        // Flag raised by the thread pool when the search should be abandoned
+        const std::atomic<bool> *pStop = nullptr;
+
+        // Check if the search has been abandoned
+        bool isStopped() {
+            return pStop && pStop->load(std::memory_order_relaxed);
+        }
+
+        // Get the static evaluation of the current board through the shared evaluation cache
+        int evaluate() {
+            bool fEvalHit;
+            int evaluation = currentBoard.readEvaluation(fEvalHit);
+
+            evalProbes++;
+            evalHits += fEvalHit;
+
+            return evaluation;
+        }
+
     public:
 
         Position(string fenString) {
@@ -43,6 +71,17 @@ class Position {
             searchPly = 0;
         }
 
+        // Load a move string in FEN notation and record the previous position for the repetition detection
+        void loadMoveString(const string &moveString) {
+
+            U64 hashKey = currentBoard.getHashKey();
+
+            if (currentBoard.loadMoveString(moveString)) {
+                repetitions[repetitionIndex] = hashKey;
+                repetitionIndex++;
+            }
+        }
+
         U64 perft(int depth) {
 
             U64 nodes = 0ULL;
@@ -55,15 +94,13 @@ class Position {
 
             for (int moveIndex = 0; moveIndex < moves.getCount(); moveIndex++) {
 
-                Board temporaryBoard = currentBoard;
+                UndoInfo undo;
 
-                if (!currentBoard.makeMove(moves.getMoves()[moveIndex])) {
-                    continue;
-                }
+                currentBoard.makeMove(moves.getMoves()[moveIndex], undo);
 
                 nodes += perft(depth - 1);
 
-                currentBoard = temporaryBoard;
+                currentBoard.unmakeMove(moves.getMoves()[moveIndex], undo);
             }
 
             return nodes;
@@ -83,17 +120,15 @@ class Position {
 
                 int currentMove = moves.getMoves()[moveIndex];
 
-                Board temporaryBoard = currentBoard;
+                UndoInfo undo;
 
-                if (!currentBoard.makeMove(currentMove)) {
-                    continue;
-                }
+                currentBoard.makeMove(currentMove, undo);
 
                 U64 currentNodes = perft(depth - 1);
 
                 nodes += currentNodes;
 
-                currentBoard = temporaryBoard;
+                currentBoard.unmakeMove(currentMove, undo);
 
                 cout << "Move: " << SQUARE_INDEX_TO_COORDINATES[getStartSquareIndex(currentMove)] << SQUARE_INDEX_TO_COORDINATES[getTargetSquareIndex(currentMove)];
                 cout << ((getPromotedPiece(currentMove) != 0) ? PIECE_INDEX_TO_ASCII[getPromotedPiece(currentMove)] : ' ');
@@ -105,113 +140,11 @@ class Position {
             std::cout << "\nTest time: " << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() << " microseconds\n\n";
         }
 
-        void updatePVScore(MoveList &moveList) {
-
-            fPVFollow = false;
-
-            for (int moveIndex = 0; moveIndex < moveList.getCount(); moveIndex++) {
-                if (moveList.getMoves()[moveIndex] == pvTable[0][searchPly]) {
-                    fPVScore = true;
-                    fPVFollow = true;
-                }
-            }
-        }
-
-        int scoreMove(int move) {
-
-            if (fPVScore && pvTable[0][searchPly] == move) {
-                fPVScore = false;
-                return 15000;
-            }
-
-            if (isCapture(move)) {
-
-                int targetPiece = 0, startPiece = 0, endPiece = 0;
-
-                if (currentBoard.getSideToMove() == white) {
-                    startPiece = blackPawn;
-                    endPiece = blackKing;
-                } else if (currentBoard.getSideToMove() == black) {
-                    startPiece = whitePawn;
-                    endPiece = whiteKing;
-                }
-
-                for (int currentPiece = startPiece; currentPiece <= endPiece; currentPiece++) {
-                    if (getBit(currentBoard.getBitboards()[currentPiece], getTargetSquareIndex(move))) {
-                        targetPiece = currentPiece;
-                        break;
-                    }
-                }
-
-                return MVV_LVA[getPiece(move)][targetPiece] + 10000;
-
-            } else if (killerMoves[0][searchPly] == move) {
-                return 5000;
-            } else if (killerMoves[1][searchPly] == move) {
-                return 1000;
-            } else if (historyMoves[getPiece(move)][searchPly] == move) {
-                return 100;
-            }
-
-            return 0;
-        }
-
-        void merge(int *moveArray, int leftIndex, int middleIndex, int rightIndex) {
-
-            int leftArraySize = middleIndex - leftIndex + 1;
-            int rightArraySize = rightIndex - middleIndex;
-
-            int leftArray[128], rightArray[128];
-
-            for (int i = 0; i < leftArraySize; i++) {
-                leftArray[i] = moveArray[leftIndex + i];
-            }
-
-            for (int j = 0; j < rightArraySize; j++) {
-                rightArray[j] = moveArray[middleIndex + j + 1];
-            }
-
-            int i = 0, j = 0, k = leftIndex;
-
-            while (i < leftArraySize && j < rightArraySize) {
-                if (scoreMove(leftArray[i]) > scoreMove(rightArray[j])) {
-                    moveArray[k] = leftArray[i];
-                    i++;
-                } else {
-                    moveArray[k] = rightArray[j];
-                    j++;
-                }
-                k++;
-            }
-
-            while (i < leftArraySize) {
-                moveArray[k] = leftArray[i];
-                i++; k++;
-            }
-
-            while (j < rightArraySize) {
-                moveArray[k] = rightArray[j];
-                j++; k++;
-            }
-        }
-
-        void mergeSort(int *moveArray, int leftIndex, int rightIndex) {
-
-            if (leftIndex < rightIndex) {
-                int middleIndex = leftIndex + (rightIndex - leftIndex) / 2;
-                mergeSort(moveArray, leftIndex, middleIndex);
-                mergeSort(moveArray, middleIndex + 1, rightIndex);
-                merge(moveArray, leftIndex, middleIndex, rightIndex);
-            }
-        }
-
-        void sortMoves(MoveList &moveList) {
-            mergeSort(moveList.getMoves(), 0, moveList.getCount() - 1);
-        }
-
         int quiescence(int alpha, int beta) {
 
-            int evaluation = currentBoard.staticEvaluate();
+            nodes++;
+
+            int evaluation = evaluate();
 
             if (evaluation >= beta) {
                 return beta;
@@ -221,41 +154,37 @@ class Position {
                 alpha = evaluation;
             }
 
-            MoveList moves = currentBoard.generateMoves();
-            sortMoves(moves);
+            MovePicker picker(currentBoard, 0, 0, 0, historyMoves, captureMoves);
 
-            for (int moveIndex = 0; moveIndex < moves.getCount(); moveIndex++) {
+            int currentMove;
 
-                int currentMove = moves.getMoves()[moveIndex];
+            while ((currentMove = picker.nextMove())) {
 
-                if (isCapture(currentMove)) {
+                UndoInfo undo;
 
-                    Board temporaryBoard = currentBoard;
+                repetitions[repetitionIndex] = currentBoard.getHashKey();
+                repetitionIndex++;
+                searchPly++;
 
-                    repetitions[repetitionIndex] = currentBoard.getHashKey();
-                    repetitionIndex++;
-                    searchPly++;
+                currentBoard.makeMove(currentMove, undo);
 
-                    if (!currentBoard.makeMove(moves.getMoves()[moveIndex])) {
-                        repetitionIndex--;
-                        searchPly--;
-                        continue;
-                    }
+                int score = -quiescence(-beta, -alpha);
 
-                    int score = -quiescence(-beta, -alpha);
+                repetitionIndex--;
+                searchPly--;
 
-                    repetitionIndex--;
-                    searchPly--;
+                currentBoard.unmakeMove(currentMove, undo);
 
-                    currentBoard = temporaryBoard;
+                if (isStopped()) {
+                    return 0;
+                }
 
-                    if (score >= beta) {
-                        return beta;
-                    }
+                if (score >= beta) {
+                    return beta;
+                }
 
-                    if (score > alpha) {
-                        alpha = score;
-                    }
+                if (score > alpha) {
+                    alpha = score;
                 }
             }
 
@@ -265,7 +194,7 @@ class Position {
         bool isRepetition() {
 
             for (int i = 0; i < repetitionIndex; i++) {
-                if (repetitions[i] == (U64)currentBoard.getHashKey()) {
+                if (repetitions[i] == currentBoard.getHashKey()) {
                     return true;
                 }
             }
@@ -276,6 +205,12 @@ class Position {
 
             int score;
 
+            if (isStopped()) {
+                return 0;
+            }
+
+            nodes++;
+
             bool isPV = beta - alpha > 1;
 
             pvLength[searchPly] = searchPly;
@@ -284,7 +219,16 @@ class Position {
                 return DRAW_SCORE;
             }
 
-            if (!isPV && (score = currentBoard.readHashEntry(alpha, beta, depth, searchPly)) != fHASH_NOT_FOUND) {
+            bool fHashHit;
+            int nodeHashMove;
+
+            // Probe every node for the move ordering, but only take the cutoffs outside of the principal variation
+            score = currentBoard.readHashEntry(alpha, beta, depth, searchPly, fHashHit, nodeHashMove);
+
+            hashProbes++;
+            hashHits += fHashHit;
+
+            if (!isPV && score != fHASH_NOT_FOUND) {
                 return score;
             }
 
@@ -293,7 +237,7 @@ class Position {
             }
 
             if (searchPly > MAX_SEARCH_DEPTH - 1) {
-                return currentBoard.staticEvaluate();
+                return evaluate();
             }
 
             bool inCheck = currentBoard.isKingInCheck();
@@ -304,26 +248,24 @@ class Position {
 
             if (depth >= REDUCTION_LIMIT && !inCheck && searchPly) {
 
-                Board nullMoveTemporaryBoard = currentBoard;
+                UndoInfo nullMoveUndo;
 
                 repetitions[repetitionIndex] = currentBoard.getHashKey();
                 repetitionIndex++;
                 searchPly++;
 
-                if (currentBoard.getEnPassantSquareIndex() != NO_SQUARE_INDEX) {
-                    currentBoard.updateHashKey(ENPASSANT_KEYS[currentBoard.getEnPassantSquareIndex()]);
-                }
-
-                currentBoard.resetEnPassantSquareIndex();
-                currentBoard.switchSideToMove();
-                currentBoard.updateHashKey(SIDE_KEY);
+                currentBoard.makeNullMove(nullMoveUndo);
 
                 score = -negamax(-beta, -beta + 1, depth - REDUCTION_LIMIT);
 
                 repetitionIndex--;
                 searchPly--;
 
-                currentBoard = nullMoveTemporaryBoard;
+                currentBoard.unmakeNullMove(nullMoveUndo);
+
+                if (isStopped()) {
+                    return 0;
+                }
 
                 if (score >= beta) {
                     return beta;
@@ -332,31 +274,25 @@ class Position {
 
             int legalMoves = 0;
 
-            MoveList moves = currentBoard.generateMoves();
-
-            if (fPVFollow) {
-                updatePVScore(moves);
-            }
-
-            sortMoves(moves);
+            MovePicker picker(currentBoard, nodeHashMove, killerMoves[0][searchPly], killerMoves[1][searchPly], historyMoves, inCheck ? evasionMoves : allMoves);
 
             int movesSearched = 0;
 
-            for (int moveIndex = 0; moveIndex < moves.getCount(); moveIndex++) {
+            // The node is an upper bound unless a move raises alpha
+            int hashFlag = fALPHA_HASH;
+            int nodeBestMove = 0;
 
-                Board temporaryBoard = currentBoard;
+            int currentMove;
 
-                int currentMove = moves.getMoves()[moveIndex];
+            while ((currentMove = picker.nextMove())) {
+
+                UndoInfo undo;
 
                 repetitions[repetitionIndex] = currentBoard.getHashKey();
                 repetitionIndex++;
                 searchPly++;
 
-                if (!currentBoard.makeMove(currentMove)) {
-                    repetitionIndex--;
-                    searchPly--;
-                    continue;
-                }
+                currentBoard.makeMove(currentMove, undo);
 
                 legalMoves++;
 
@@ -387,13 +323,18 @@ class Position {
                 repetitionIndex--;
                 movesSearched++;
 
-                currentBoard = temporaryBoard;
+                currentBoard.unmakeMove(currentMove, undo);
+
+                if (isStopped()) {
+                    return 0;
+                }
 
                 if (score >= beta) {
 
-                    currentBoard.writeHashEntry(beta, depth, searchPly, fBETA_HASH);
+                    currentBoard.writeHashEntry(beta, depth, searchPly, fBETA_HASH, currentMove);
 
-                    if (!isCapture(currentMove)) {
+                    // A killer refuting again keeps the second slot for another move
+                    if (!isCapture(currentMove) && currentMove != killerMoves[0][searchPly]) {
                         killerMoves[1][searchPly] = killerMoves[0][searchPly];
                         killerMoves[0][searchPly] = currentMove;
                     }
@@ -404,10 +345,12 @@ class Position {
                 if (score > alpha) {
 
                     if (!isCapture(currentMove)) {
-                        historyMoves[getPiece(currentMove)][getTargetSquareIndex(currentMove)] = currentMove;
+                        historyMoves[getPiece(currentMove)][getTargetSquareIndex(currentMove)] += depth;
                     }
 
                     alpha = score;
+                    hashFlag = fPV_HASH;
+                    nodeBestMove = currentMove;
 
                     pvTable[searchPly][searchPly] = currentMove;
 
@@ -431,7 +374,7 @@ class Position {
                 }
             }
 
-            currentBoard.writeHashEntry(beta, depth, searchPly, fBETA_HASH);
+            currentBoard.writeHashEntry(alpha, depth, searchPly, hashFlag, nodeBestMove);
             return alpha;
         }
 
@@ -442,8 +385,42 @@ class Position {
             }
         }
 
+        // Search the position with iterative deepening, each iteration searching depthOffset plies deeper than its index
+        void iterativeDeepening(int depth, int depthOffset, bool fVerbose) {
+
+            int alpha = -INF, beta = INF;
+
+            for (int currentDepth = 1; currentDepth <= depth; currentDepth++) {
+
+                int score = negamax(alpha, beta, currentDepth + depthOffset);
+
+                if (isStopped()) {
+                    break;
+                }
+
+                // A score outside the aspiration window is only a bound, so the same depth is searched again with the full window
+                if (((score <= alpha) || (score >= beta)) && ((alpha != -INF) || (beta != INF))) {
+                    alpha = -INF;
+                    beta = INF;
+                    currentDepth--;
+                    continue;
+                }
+
+                alpha = score - ASPIRATION_WINDOW;
+                beta = score + ASPIRATION_WINDOW;
+
+                if (fVerbose) {
+                    cout << "\n\nEvaluation: " << score;
+                    cout << "\nPrincipled variation: ";
+                    printPV();
+                }
+            }
+        }
+
         void resetSearchVariables() {
-            bestMove = 0; searchPly = 0;
+            bestMove = 0; searchPly = 0; nodes = 0ULL;
+            hashProbes = 0ULL; hashHits = 0ULL;
+            evalProbes = 0ULL; evalHits = 0ULL;
             memset(killerMoves, 0, sizeof(killerMoves));
             memset(historyMoves, 0, sizeof(historyMoves));
             memset(pvTable, 0, sizeof(pvTable));
@@ -454,6 +431,41 @@ class Position {
             return bestMove;
         }
 
+        U64 getNodes() {
+            return nodes;
+        }
+
+        U64 getHashProbes() {
+            return hashProbes;
+        }
+
+        U64 getHashHits() {
+            return hashHits;
+        }
+
+        U64 getEvalProbes() {
+            return evalProbes;
+        }
+
+        U64 getEvalHits() {
+            return evalHits;
+        }
+
+        // Share the stop flag of the thread pool with this position
+        void setStopFlag(const std::atomic<bool> *pStopFlag) {
+            pStop = pStopFlag;
+        }
+
+        // Cache the pawn structure evaluation of this position's searches in the given table
+        void setPawnHashTable(PawnHashTable *pTable) {
+            currentBoard.setPawnHashTable(pTable);
+        }
+
+        // Evaluate this position's searches with the given neural network, or with the hand-crafted evaluation if it is null
+        void setNetwork(const NeuralNetwork *pNetwork) {
+            currentBoard.setNetwork(pNetwork);
+        }
+
         Board getBoard() {
             return currentBoard;
         }
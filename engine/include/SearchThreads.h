@@ -0,0 +1,74 @@
+#ifndef SEARCH_THREADS_H
+#define SEARCH_THREADS_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "PawnHashTable.h"
+#include "NeuralNetwork.h"
+#include "typedef.h"
+
+class SearchThreads
+{
+
+private:
+    // Number of threads searching the root, including the main thread
+    int numThreads = 1;
+
+    // Raised once the main thread has finished so the helper threads abandon their search
+    std::atomic<bool> fStop{false};
+
+    // One pawn hash table per thread, kept between searches as the pawn structures recur
+    std::vector<PawnHashTable> pawnTables;
+
+    // Neural network evaluating the positions, or null for the hand-crafted evaluation
+    const NeuralNetwork *pNetwork = nullptr;
+
+    // Nodes visited by all of the threads during the last search
+    U64 nodes = 0ULL;
+
+    // Transposition table probes and hits of all of the threads during the last search
+    U64 hashProbes = 0ULL;
+    U64 hashHits = 0ULL;
+
+    // Pawn hash table probes and hits of all of the threads during the last search
+    U64 pawnHashProbes = 0ULL;
+    U64 pawnHashHits = 0ULL;
+
+    // Evaluation cache probes and hits of all of the threads during the last search
+    U64 evalCacheProbes = 0ULL;
+    U64 evalCacheHits = 0ULL;
+
+public:
+    // Class constructor to set the number of search threads
+    SearchThreads(int numThreads = 1);
+
+    // Set the number of search threads
+    void setNumThreads(int numThreads);
+
+    int getNumThreads() const;
+
+    // Evaluate with the given neural network, or with the hand-crafted evaluation if it is null
+    void setNetwork(const NeuralNetwork *pNetwork);
+
+    // Search the position with Lazy SMP and return the best move found by the main thread
+    int search(const std::string &fenString, int depth, bool fVerbose);
+
+    // Get the number of nodes visited during the last search
+    U64 getNodes() const;
+
+    // Get the transposition table statistics of the last search
+    U64 getHashProbes() const;
+    U64 getHashHits() const;
+
+    // Get the pawn hash table statistics of the last search
+    U64 getPawnHashProbes() const;
+    U64 getPawnHashHits() const;
+
+    // Get the evaluation cache statistics of the last search
+    U64 getEvalCacheProbes() const;
+    U64 getEvalCacheHits() const;
+};
+
+#endif
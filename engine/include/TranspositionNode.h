@@ -1,14 +1,71 @@
 #ifndef TRANSPOSITIONNODE_H
 #define TRANSPOSITIONNODE_H
 
+#include <atomic>
+#include <cstdint>
+
 #include "typedef.h"
 
+/*
+A transposition node is two 64-bit words: the data word packs the move, score, depth, flag and generation,
+and the key word holds the hash key XOR-ed with the data word.
+Both words are read and written atomically without locks, and a node whose words were
+written by different threads fails the key check, so a torn entry is never returned.
+*/
 struct TranspositionNode
 {
-    U64 hashKey = 0;
-    int depth = 0;
-    int flag = 0;
-    int score = 0;
+    std::atomic<U64> key{0};
+    std::atomic<U64> data{0};
+
+    // Write the data word and the validating key word
+    inline void save(U64 hashKey, U64 hashData)
+    {
+        data.store(hashData, std::memory_order_relaxed);
+        key.store(hashKey ^ hashData, std::memory_order_relaxed);
+    }
+
+    // Read the data word, returning false if the node does not belong to the hash key
+    inline bool load(U64 hashKey, U64 &hashData) const
+    {
+        hashData = data.load(std::memory_order_relaxed);
+        return (key.load(std::memory_order_relaxed) ^ hashData) == hashKey;
+    }
 };
 
-#endif
\ No newline at end of file
+// Pack the move, score, depth, flag and generation into a data word
+inline U64 packHashData(int move, int score, int depth, int flag, int generation)
+{
+    return (U64)(move & 0xffffff) | ((U64)(score & 0x3ffff) << 24) | ((U64)(depth & 0xff) << 42) | ((U64)(flag & 0x3) << 50) | ((U64)(generation & 0x3f) << 52);
+}
+
+// Get the best move from a data word
+inline int getHashMove(U64 hashData)
+{
+    return hashData & 0xffffff;
+}
+
+// Get the score from a data word, sign extending the 18-bit field
+inline int getHashScore(U64 hashData)
+{
+    return (int)((int64_t)(hashData << 22) >> 46);
+}
+
+// Get the depth from a data word
+inline int getHashDepth(U64 hashData)
+{
+    return (hashData >> 42) & 0xff;
+}
+
+// Get the flag from a data word
+inline int getHashFlag(U64 hashData)
+{
+    return (hashData >> 50) & 0x3;
+}
+
+// Get the generation of the search that wrote the data word
+inline int getHashGeneration(U64 hashData)
+{
+    return (hashData >> 52) & 0x3f;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <cstddef>
+
+#include "TranspositionNode.h"
+#include "typedef.h"
+#include "const.h"
+
+// A bucket of nodes filling exactly one cache line, so a probe touches a single line of memory
+struct alignas(64) TranspositionBucket
+{
+    TranspositionNode nodes[TT_BUCKET_SIZE];
+};
+
+// Enumerate the kinds of memory backing the table
+enum {standardPages, transparentHugePages, explicitHugePages};
+
+class TranspositionTable
+{
+
+private:
+    TranspositionBucket *buckets = nullptr;
+    U64 numBuckets = 0;
+
+    // Size and kind of the allocation, needed to release it
+    size_t allocatedSize = 0;
+    int pageType = standardPages;
+
+    // Generation of the current search, entries from older generations are replaced first
+    int generation = 0;
+
+    // Allocate memory for the given number of bytes of buckets, preferring huge pages, and return it with the size and kind of the allocation
+    static TranspositionBucket *allocate(size_t size, size_t &allocatedSize, int &pageType);
+
+    // Release the memory of the buckets
+    void release();
+
+    // Get the bucket of the hash key
+    inline TranspositionBucket *getBucket(U64 hashKey) const
+    {
+        // Multiply-shift maps the key onto the buckets using its high bits, which avoids a division
+        return &buckets[(U64)(((unsigned __int128)hashKey * numBuckets) >> 64)];
+    }
+
+public:
+    // The table is allocated on demand, either by resize() or by the first search
+    TranspositionTable() {}
+
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+    // Reallocate the table with the given size in megabytes and clear it
+    void resize(int megabytes);
+
+    // Remove all of the entries
+    void clear();
+
+    // Advance the generation at the start of every search
+    void startNewSearch();
+
+    // Start loading the bucket of the hash key into the cache ahead of the probe
+    inline void prefetch(U64 hashKey) const
+    {
+        __builtin_prefetch(getBucket(hashKey));
+    }
+
+    // Find the data word stored for the hash key, returning false if there is none
+    bool probe(U64 hashKey, U64 &hashData);
+
+    // Store an entry, replacing the shallowest and oldest node of the bucket
+    void store(U64 hashKey, int move, int score, int depth, int flag);
+
+    // Get the size of the table in megabytes
+    int getMegabytes() const;
+
+    // Get the kind of memory backing the table
+    int getPageType() const;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef UNDOINFO_H
+#define UNDOINFO_H
+
+#include "typedef.h"
+
+/*
+The state a move destroys or is cheaper to restore than to recompute: the captured piece and the castling rights,
+en passant square, hash keys and evaluation accumulators of the position before the move.
+Each ply of the search keeps one record on its stack frame instead of a copy of the whole board.
+*/
+struct UndoInfo
+{
+    U64 hashKey;
+    U64 pawnKey;
+    int capturedPiece;
+    int enPassantSquareIndex;
+    int canCastle;
+    int pieceSquareScore[2];
+    int gameScore;
+};
+
+#endif
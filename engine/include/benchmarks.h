@@ -0,0 +1,42 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include "NeuralNetwork.h"
+
+// Search the benchmark positions to a fixed depth and report time to depth, nodes, NPS and the hash hit rates, evaluating with the network if one is given
+void benchmarkSearch(int depth, const NeuralNetwork *pNetwork = nullptr);
+
+// Count the perft leaves of the benchmark positions and report the time and leaves per second
+void benchmarkPerft(int depth);
+
+// Measure the average cost of making and unmaking the moves of the benchmark positions
+void benchmarkMakeMove(int numIterations);
+
+// Measure the average cost of the hand-crafted evaluation and of the move generation over the benchmark positions and the positions up to two plies from them, and of the network evaluation and its updates if one is given
+void benchmarkEvaluation(int numIterations, const NeuralNetwork *pNetwork = nullptr);
+
+// Measure the Lazy SMP speedup and nodes per second for 1 up to maxThreads threads
+void benchmarkLazySMP(int maxThreads, int depth);
+
+// Measure the startup work left at runtime, against building the compile-time tables and searching for the magic numbers as earlier starts did
+void benchmarkStartup(int numIterations);
+
+// Measure the hardware population count, LS1B and pop-LSB against the loops they replaced
+void benchmarkBitScans(int numIterations);
+
+// Measure the rook and bishop attack lookups of the backends the build offers on random occupancies, checking that they agree
+void benchmarkSliderLookups(int numIterations);
+
+// Measure a whole-board attack map of the sliding pieces from the attack table against the scalar and vector Kogge-Stone fills
+void benchmarkAttackMaps(int numIterations);
+
+// Measure the latency of transposition table probes with and without a prefetch issued ahead of them
+void benchmarkHashPrefetch(int numProbes);
+
+// Hammer the transposition table from many threads and return true if no torn entry was read
+bool stressTestTranspositionTable(int numThreads, int numOperations);
+
+// Check that the generated moves are legal and that the capture, quiet and evasion generators agree with the full generator and the known perft results
+bool verifyMoveGeneration(int depth);
+
+#endif
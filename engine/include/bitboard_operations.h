@@ -2,60 +2,75 @@
 #define BITBOARD_OPERATIONS_H
 
 #include <iostream>
-#include <exception>
+#include <stdexcept>
 
 #include "typedef.h"
 
 // Set a bit at the given square index on the given bitboard
-inline void setBit(U64 &bitboard, int squareIndex)
+constexpr void setBit(U64 &bitboard, int squareIndex)
 {
     bitboard |= (1ULL << squareIndex);
 }
 
 // Pop the bit at the given square index on the given bitboard
-inline void popBit(U64 &bitboard, int squareIndex)
+constexpr void popBit(U64 &bitboard, int squareIndex)
 {
-    bitboard & (1ULL << squareIndex) ? bitboard ^= (1ULL << squareIndex) : 0;
+    bitboard &= ~(1ULL << squareIndex);
 }
 
 // Get a bit at the given square index on the given bitboard
-inline int getBit(U64 bitboard, int squareIndex)
+constexpr int getBit(U64 bitboard, int squareIndex)
 {
     return (bitboard & (1ULL << squareIndex)) ? 1 : 0;
 }
 
+/*
+The operations above and the bit scans below are constexpr, so the lookup tables built from them are generated at compile time.
+The bit scans are compiler builtins, which become single POPCNT and TZCNT instructions when the target has them
+(-march=native on most x86-64 CPUs), a short bit-twiddling sequence when it does not, and i64.popcnt and i64.ctz in WebAssembly
+*/
+
 // Get the cardinality of the given bitboard
-inline int getPopulationCount(U64 bitboard)
+constexpr int getPopulationCount(U64 bitboard)
 {
-    int populationCount = 0;
-
-    // While there are bits on the bitboard
-    while (bitboard)
-    {
-
-        // Increment the populationCount variable
-        populationCount++;
-        // Remove the LS1B of the bitboard
-        bitboard &= bitboard - 1;
-    }
+    return __builtin_popcountll(bitboard);
+}
 
-    return populationCount;
+// Get the files holding a bit of the given bitboard, filled from the 8th to the 1st rank
+constexpr U64 getFileFill(U64 bitboard)
+{
+    // Smear the bits towards the 8th rank, then towards the 1st rank
+    bitboard |= bitboard >> 8;
+    bitboard |= bitboard >> 16;
+    bitboard |= bitboard >> 32;
+    bitboard |= bitboard << 8;
+    bitboard |= bitboard << 16;
+    bitboard |= bitboard << 32;
+
+    return bitboard;
 }
 
-// Get the LS1B if of the given bitboard
-inline int getLS1BIndex(U64 bitboard)
+// Get the LS1B index of the given bitboard, which must not be empty
+constexpr int getLS1BIndex(U64 bitboard)
 {
-    // If a non-empty bitboard is passed
-    if (bitboard)
-    {
-        // Bit manipulation to get the population count the trailing bits
-        return getPopulationCount((bitboard & -bitboard) - 1);
-        // If an empty bitboard is passed
-    }
-    else
+#ifdef DEBUG_BUILD
+    // The result is undefined for an empty bitboard, so only the debug build pays for the check
+    if (!bitboard)
     {
         throw std::invalid_argument("Invalid bitboard: empty bitboard");
     }
+#endif
+
+    return __builtin_ctzll(bitboard);
+}
+
+// Get the LS1B index of the given bitboard, which must not be empty, and remove the bit from it
+constexpr int popLSB(U64 &bitboard)
+{
+    int squareIndex = getLS1BIndex(bitboard);
+    bitboard &= bitboard - 1;
+
+    return squareIndex;
 }
 
 // Print the given bitboard
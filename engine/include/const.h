@@ -13,7 +13,7 @@ const U64 NOT_H_FILE = 9187201950435737471ULL;
 const U64 NOT_HG_FILE = 4557430888798830399ULL;
 
 //Relevant bit constants
-const int BISHOP_RELEVANT_BITS[64] = {
+constexpr int BISHOP_RELEVANT_BITS[64] = {
     6, 5, 5, 5, 5, 5, 5, 6, 
     5, 5, 5, 5, 5, 5, 5, 5,
     5, 5, 7, 7, 7, 7, 5, 5,
@@ -24,7 +24,7 @@ const int BISHOP_RELEVANT_BITS[64] = {
     6, 5, 5, 5, 5, 5, 5, 6,
 };
 
-const int ROOK_RELEVANT_BITS[64] = {
+constexpr int ROOK_RELEVANT_BITS[64] = {
     12, 11, 11, 11, 11, 11, 11, 12, 
     11, 10, 10, 10, 10, 10, 10, 11,
     11, 10, 10, 10, 10, 10, 10, 11,
@@ -35,6 +35,50 @@ const int ROOK_RELEVANT_BITS[64] = {
     12, 11, 11, 11, 11, 11, 11, 12
 };
 
+// Entries of the packed sliding piece attack tables, 2^relevant bits for every square of the bishop and then of the rook
+const int SLIDER_BISHOP_ENTRIES = 5248;
+const int SLIDER_ROOK_ENTRIES = 102400;
+const int SLIDER_TABLE_SIZE = SLIDER_BISHOP_ENTRIES + SLIDER_ROOK_ENTRIES;
+
+// Magic numbers hashing the relevant occupancy of each square into its attack table, found offline by ./main magics
+constexpr U64 BISHOP_MAGIC_NUMBERS[64] = {
+    0x8060020428028011ULL, 0x0010240084004420ULL, 0x4288082108220CA0ULL, 0xA004410220008804ULL,
+    0x228110408C040804ULL, 0x0282080208020800ULL, 0x0880580210100000ULL, 0x0410460200A00400ULL,
+    0x052A29A008008301ULL, 0x0000444104091201ULL, 0x8284100090810006ULL, 0x00A324040A842008ULL,
+    0x8400040422408008ULL, 0x1252008220220010ULL, 0x0400842908021020ULL, 0x0002288221100200ULL,
+    0x0010110410220830ULL, 0x042010080200A200ULL, 0x4020824408001140ULL, 0x1188010082810000ULL,
+    0x1202048400A21004ULL, 0x0000800040602001ULL, 0x00060C6051100880ULL, 0x0101220104031402ULL,
+    0x0008450048208804ULL, 0x044108940408080BULL, 0x0008020004002200ULL, 0x0001004004040002ULL,
+    0x0141001001004002ULL, 0x8011020030405000ULL, 0x594421020C290702ULL, 0x00864208004A0208ULL,
+    0x1002821004401080ULL, 0xA429103008030400ULL, 0x0029928800100840ULL, 0x0202020080080082ULL,
+    0x0441080200002200ULL, 0x4001004100120100ULL, 0x8090208A20050100ULL, 0x02020089026A0040ULL,
+    0x0022084240280849ULL, 0x00C0543008400400ULL, 0x4000108401001007ULL, 0x0400404010400200ULL,
+    0x1000080100402402ULL, 0x0022300200200200ULL, 0x4070044804980040ULL, 0x014244820200238AULL,
+    0x20020110A2100000ULL, 0x11D0405804100800ULL, 0x0021204218040060ULL, 0x2028340104091243ULL,
+    0x204030106A088040ULL, 0x0024100250010280ULL, 0x0060605513410410ULL, 0x8002248400920000ULL,
+    0x0010820800828810ULL, 0x4412009400823004ULL, 0x0040A04042280402ULL, 0x0000802180840404ULL,
+    0x0802831042828200ULL, 0x0220042428100109ULL, 0x8000400242360A20ULL, 0x2208088118020010ULL,
+};
+
+constexpr U64 ROOK_MAGIC_NUMBERS[64] = {
+    0xA280008010244000ULL, 0x0840400010002000ULL, 0x0480200082100008ULL, 0xA500042048100100ULL,
+    0x0600082050040A00ULL, 0x2900010042082400ULL, 0xC400008250080104ULL, 0x008000D080022500ULL,
+    0x42B0802040008006ULL, 0x0002400044201004ULL, 0x0001004020010010ULL, 0x0084808088001000ULL,
+    0x1023000500100802ULL, 0x9400808002000400ULL, 0x000300010006000CULL, 0x000200090400688AULL,
+    0x068000C00040A000ULL, 0x0080808020004010ULL, 0x2000868020001001ULL, 0x00004200200A0010ULL,
+    0x0400050008001100ULL, 0x0001010008040002ULL, 0x0020808001000200ULL, 0x0109020000408401ULL,
+    0x9080004040002000ULL, 0x0500200080400080ULL, 0x22C0804200220011ULL, 0x410800808010000AULL,
+    0x0000110100080004ULL, 0x028C010040020040ULL, 0x040A000200080104ULL, 0x0100204200008421ULL,
+    0x0080400080800021ULL, 0x0240008041802000ULL, 0x0401200084801008ULL, 0x1501000821001000ULL,
+    0x0808040080800800ULL, 0x9210020080800400ULL, 0x001D000401010200ULL, 0x050000408200012CULL,
+    0x1880004420024000ULL, 0x0140081000242001ULL, 0x2101001020010046ULL, 0x0000082200120040ULL,
+    0x0000080004008080ULL, 0x500C000810020200ULL, 0x1050424108040010ULL, 0x0000008C10420005ULL,
+    0x0000290880420A00ULL, 0x84004000902D0100ULL, 0x2088802042081200ULL, 0x000100A010040B00ULL,
+    0x0800080004008080ULL, 0x8402008024008280ULL, 0x0890100102484400ULL, 0x82094C3041088200ULL,
+    0x0040410012088022ULL, 0x9003820842201102ULL, 0x05810310200040E9ULL, 0x002A490020851001ULL,
+    0x0201000408003013ULL, 0x0002000401900802ULL, 0x10B040D110020814ULL, 0x2800008040240102ULL,
+};
+
 //squareIndex -> square
 const std::string SQUARE_INDEX_TO_COORDINATES[64] = {
     "a8", "b8", "c8", "d8", "e8", "f8", "g8", "h8",
@@ -59,6 +103,7 @@ const int CASTLE_STATE[64] = {
 };
 
 const int NO_SQUARE_INDEX = -1;
+const int NO_PIECE = -1;
 const int NO_SIDE_TO_MOVE = -1;
 
 const std::string PIECE_INDEX_TO_ASCII = "PNBRQKpnbrqk";
@@ -73,7 +118,10 @@ const std::string TEST_POSITIONS_FEN[3]{
 const int OPENING_SCORE = 6192;
 const int ENDGAME_SCORE = 518;
 
-const int MATERIAL_SCORE[2][12] = {
+// Game scores over which the evaluation blends from the endgame to the opening score
+const int PHASE_RANGE = OPENING_SCORE - ENDGAME_SCORE;
+
+constexpr int MATERIAL_SCORE[2][12] = {
 
     //Opening 
     82, 337, 365, 447, 1025, 12000, -82, -337, -365, -447, -1025, -12000,
@@ -83,7 +131,7 @@ const int MATERIAL_SCORE[2][12] = {
 
 };
 
-const int POSITIONAL_SCORE[2][6][64] = {
+constexpr int POSITIONAL_SCORE[2][6][64] = {
 
     //Opening
 
@@ -246,6 +294,9 @@ const int PP_SCORE[8] = {0, 5, 25, 50, 75, 100, 150, 200};
 
 const int MAX_SEARCH_DEPTH = 64;
 
+// Number of plies the board keeps the attack info of, so a node still finds its own after searching its children
+const int ATTACK_INFO_PLIES = 8;
+
 const int INF = 50000;
 const int CHECKMATE_SCORE = 49000;
 const int CHECKMATE_BOUND = 48000;
@@ -267,17 +318,52 @@ const int MVV_LVA[12][12] =  {
     100, 200, 300, 400, 500, 600,  100, 200, 300, 400, 500, 600
 };
 
+// Piece values used to tell good captures from bad ones
+const int PIECE_VALUE[6] = {100, 320, 330, 500, 900, 20000};
+
+// Added to the MVV-LVA score of captures that do not give up material
+const int GOOD_CAPTURE_SCORE = 10000;
+
 const int FULL_DEPTH_MOVES = 4;
 const int REDUCTION_LIMIT = 3;
 
 const int ASPIRATION_WINDOW = 50;
 
+const int TT_BUCKET_SIZE = 4;
+
 #ifdef WASM_BUILD
-const int NUM_TT_ENTRIES = 0x80000;  // 512K entries ~12MB for WASM
+const int DEFAULT_TT_MEGABYTES = 8;
 #else
-const int NUM_TT_ENTRIES = 0x800000;  // 8M entries ~160MB for native
+const int DEFAULT_TT_MEGABYTES = 128;
 #endif
 
+// Size of a huge page on x86-64 and AArch64 Linux, the table is aligned to it so huge pages can back it
+const U64 HUGE_PAGE_SIZE = 2ULL * 1024 * 1024;
+
+// Number of generations kept apart by the replacement policy before the age counter wraps
+const int TT_GENERATIONS = 64;
+
+// Number of entries of every thread's pawn hash table, a power of two
+const int PAWN_HASH_ENTRIES = 16384;
+
+#ifdef WASM_BUILD
+const int DEFAULT_EVAL_CACHE_MEGABYTES = 1;
+#else
+const int DEFAULT_EVAL_CACHE_MEGABYTES = 8;
+#endif
+
+// Number of piece-square inputs and first layer neurons of each perspective of the neural network
+const int NNUE_INPUTS = 768;
+const int NNUE_HIDDEN = 256;
+
+// Quantisation of the first layer and of the output weights, and the factor scaling the output to centipawns
+const int NNUE_QA = 255;
+const int NNUE_QB = 64;
+const int NNUE_SCALE = 400;
+
+// File the bootstrap network is written to when no other name is given
+const std::string DEFAULT_NETWORK_FILE = "peach.nnue";
+
 const int fPV_HASH = 0;
 const int fALPHA_HASH = 1;
 const int fBETA_HASH = 2;
@@ -28,14 +28,86 @@ public:
 };
 
 // Create a custon exception inheriting from the standart exception class
-class MagicNumberNotInitialisedException : public std::exception
+class InvalidMagicNumberException : public std::exception
 {
 
 public:
     // Override the default message
     const char *what() const noexcept override
     {
-        return "Invalid magic numbers: magic numbers not initialised";
+        return "Invalid magic numbers: magic number maps occupancies with different attacks to the same index";
+    }
+};
+
+// Create a custon exception inheriting from the standart exception class
+class CannotAllocateHashTableException : public std::exception
+{
+
+public:
+    // Override the default message
+    const char *what() const noexcept override
+    {
+        return "Invalid hash table size: memory could not be allocated";
+    }
+};
+
+// Create a custon exception inheriting from the standart exception class
+class OccupanciesOutOfSyncException : public std::exception
+{
+
+public:
+    // Override the default message
+    const char *what() const noexcept override
+    {
+        return "Invalid occupancies: incremental occupancies differ from the piece bitboards";
+    }
+};
+
+// Create a custon exception inheriting from the standart exception class
+class EvaluationOutOfSyncException : public std::exception
+{
+
+public:
+    // Override the default message
+    const char *what() const noexcept override
+    {
+        return "Invalid evaluation: incremental material and positional scores differ from the piece bitboards";
+    }
+};
+
+// Create a custon exception inheriting from the standart exception class
+class AttackInfoOutOfSyncException : public std::exception
+{
+
+public:
+    // Override the default message
+    const char *what() const noexcept override
+    {
+        return "Invalid attack info: cached attacks differ from the attacks of the position";
+    }
+};
+
+// Create a custon exception inheriting from the standart exception class
+class CannotLoadNetworkException : public std::exception
+{
+
+public:
+    // Override the default message
+    const char *what() const noexcept override
+    {
+        return "Invalid network file: the weights could not be loaded";
+    }
+};
+
+// Create a custon exception inheriting from the standart exception class
+class CannotWriteNetworkException : public std::exception
+{
+
+public:
+    // Override the default message
+    const char *what() const noexcept override
+    {
+        return "Invalid network file: the weights could not be written";
     }
 };
 
@@ -17,7 +17,7 @@ enum {
 Convert a square into the squareIndex from the black piece perspective
 Used in the staticEvaluate() function
 */
-const int OPPOSITE_SIDE[64] = {
+constexpr int OPPOSITE_SIDE[64] = {
 	a1, b1, c1, d1, e1, f1, g1, h1,
 	a2, b2, c2, d2, e2, f2, g2, h2,
 	a3, b3, c3, d3, e3, f3, g3, h3,
@@ -46,5 +46,11 @@ enum {white, black, both};
 //Enumerate castling rights
 enum {K=1, Q=2, k=4, q=8};
 
+//Enumerate move generation types
+enum {allMoves, captureMoves, quietMoves, evasionMoves};
+
+//Enumerate sliding piece attack backends
+enum {magicSliders, pextSliders, koggeStoneSliders};
+
 
 #endif
\ No newline at end of file
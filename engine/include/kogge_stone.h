@@ -0,0 +1,126 @@
+#ifndef KOGGE_STONE_H
+#define KOGGE_STONE_H
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "typedef.h"
+#include "const.h"
+
+/*
+Sliding piece attacks computed without lookup tables by Kogge-Stone occluded fills. Each direction is a shift of the bitboard,
+positive towards h1, and every slider of a set is filled along it at once in three doubling steps, the empty squares
+propagating how far the sliders may run. They cost a few dozen instructions in place of a memory access, so they suit
+targets short on memory and attacks of whole piece sets, where one fill serves every piece.
+*/
+
+// Get the squares a step in the direction may land on, which excludes the file it wraps onto from the other edge
+constexpr U64 getFillWrapMask(int shift)
+{
+    int fileStep = ((shift % 8) + 8) % 8;
+
+    return (fileStep == 1) ? NOT_A_FILE : (fileStep == 7) ? NOT_H_FILE : ~0ULL;
+}
+
+// Shift the bitboard by the given number of squares, towards h1 if it is positive and towards a8 otherwise
+template <int Shift>
+constexpr U64 shiftBitboard(U64 bitboard)
+{
+    if constexpr (Shift > 0)
+    {
+        return bitboard << Shift;
+    }
+    else
+    {
+        return bitboard >> -Shift;
+    }
+}
+
+// Get the squares the sliders attack in one direction, up to and including the first occupied square
+template <int Shift>
+constexpr U64 getRayFillAttacks(U64 sliders, U64 empty)
+{
+    constexpr U64 WRAP_MASK = getFillWrapMask(Shift);
+
+    // Smear the sliders over the empty squares in steps of one, two and four squares
+    empty &= WRAP_MASK;
+    sliders |= empty & shiftBitboard<Shift>(sliders);
+    empty &= shiftBitboard<Shift>(empty);
+    sliders |= empty & shiftBitboard<2 * Shift>(sliders);
+    empty &= shiftBitboard<2 * Shift>(empty);
+    sliders |= empty & shiftBitboard<4 * Shift>(sliders);
+
+    // One more step reaches the blockers and the edge squares
+    return shiftBitboard<Shift>(sliders) & WRAP_MASK;
+}
+
+// Get the squares attacked by all of the given bishops at once
+constexpr U64 getBishopFillAttacks(U64 bishops, U64 occupancy)
+{
+    return getRayFillAttacks<9>(bishops, ~occupancy) | getRayFillAttacks<-9>(bishops, ~occupancy) |
+           getRayFillAttacks<7>(bishops, ~occupancy) | getRayFillAttacks<-7>(bishops, ~occupancy);
+}
+
+// Get the squares attacked by all of the given rooks at once
+constexpr U64 getRookFillAttacks(U64 rooks, U64 occupancy)
+{
+    return getRayFillAttacks<8>(rooks, ~occupancy) | getRayFillAttacks<-8>(rooks, ~occupancy) |
+           getRayFillAttacks<1>(rooks, ~occupancy) | getRayFillAttacks<-1>(rooks, ~occupancy);
+}
+
+/*
+The same fills vectorised across the directions. A line is filled both ways in two lanes, the first shifted towards h1 and the
+second towards a8 by the same number of squares, so an AVX2 vector fills the two lines of a piece at once. The scalar fills
+above are used on targets without AVX2, as 128-bit vectors filling one line at a time are no faster than them.
+*/
+#if defined(__AVX2__)
+
+#define FILL_SIMD
+const char FILL_SIMD_NAME[] = "AVX2";
+
+// Shift the lanes holding the rays of two lines to the next square, towards h1 in the even lanes and towards a8 in the odd ones
+template <int Shift1, int Shift2>
+static inline __m256i shiftRays(__m256i rays)
+{
+    const __m256i counts = _mm256_set_epi64x(Shift2, Shift2, Shift1, Shift1);
+
+    return _mm256_blend_epi32(_mm256_sllv_epi64(rays, counts), _mm256_srlv_epi64(rays, counts), 0xcc);
+}
+
+// Get the squares the sliders attack both ways along two lines, each given by the shift to the next square towards h1
+template <int Shift1, int Shift2>
+static inline U64 getLineFillAttacks(U64 sliders, U64 occupancy)
+{
+    const __m256i wrapMask = _mm256_set_epi64x(getFillWrapMask(-Shift2), getFillWrapMask(Shift2), getFillWrapMask(-Shift1), getFillWrapMask(Shift1));
+
+    __m256i rays = _mm256_set1_epi64x(sliders);
+    __m256i empty = _mm256_andnot_si256(_mm256_set1_epi64x(occupancy), wrapMask);
+
+    rays = _mm256_or_si256(rays, _mm256_and_si256(empty, shiftRays<Shift1, Shift2>(rays)));
+    empty = _mm256_and_si256(empty, shiftRays<Shift1, Shift2>(empty));
+    rays = _mm256_or_si256(rays, _mm256_and_si256(empty, shiftRays<2 * Shift1, 2 * Shift2>(rays)));
+    empty = _mm256_and_si256(empty, shiftRays<2 * Shift1, 2 * Shift2>(empty));
+    rays = _mm256_or_si256(rays, _mm256_and_si256(empty, shiftRays<4 * Shift1, 4 * Shift2>(rays)));
+    rays = _mm256_and_si256(shiftRays<Shift1, Shift2>(rays), wrapMask);
+
+    // Merge the four rays
+    __m128i attacks = _mm_or_si128(_mm256_castsi256_si128(rays), _mm256_extracti128_si256(rays, 1));
+    return (U64)(_mm_cvtsi128_si64(attacks) | _mm_extract_epi64(attacks, 1));
+}
+
+// Get the squares attacked by all of the given bishops at once, filling the four diagonal rays in one vector
+static inline U64 getBishopFillAttacksSimd(U64 bishops, U64 occupancy)
+{
+    return getLineFillAttacks<9, 7>(bishops, occupancy);
+}
+
+// Get the squares attacked by all of the given rooks at once, filling the four orthogonal rays in one vector
+static inline U64 getRookFillAttacksSimd(U64 rooks, U64 occupancy)
+{
+    return getLineFillAttacks<8, 1>(rooks, occupancy);
+}
+
+#endif
+
+#endif
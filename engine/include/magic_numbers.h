@@ -1,18 +1,170 @@
 #ifndef MAGICS_NUMBERS_H
 #define MAGICS_NUMBERS_H
 
+#include "bitboard_operations.h"
 #include "typedef.h"
 
 // Dynamically generate bishop attack mask for a given occupancy and the square index
-U64 generateBishopAttacks(int squareIndex, const U64 &occupancy);
+constexpr U64 generateBishopAttacks(int squareIndex, const U64 &occupancy)
+{
+    U64 attacksBitboard = 0ULL;
+
+    int rank = 0, file = 0;
+
+    // Get the file and the rank from the square index
+    int targetRank = squareIndex / 8;
+    int targetFile = squareIndex % 8;
+
+    // Cast an attack ray in the positive file and positive rank direction
+    for (rank = targetRank + 1, file = targetFile + 1; rank < 8 && file < 8; rank++, file++)
+    {
+        // Set the bit on the attack bitboard
+        setBit(attacksBitboard, rank * 8 + file);
+
+        // Break out the loop if the piece is found at the current square index
+        if (getBit(occupancy, rank * 8 + file))
+        {
+            break;
+        }
+    }
+
+    // Cast an attack ray in the positive file and negative rank direction
+    for (rank = targetRank - 1, file = targetFile + 1; rank >= 0 && file < 8; rank--, file++)
+    {
+        // Set the bit on the attack bitboard
+        setBit(attacksBitboard, rank * 8 + file);
+
+        // Break out the loop if the piece is found at the current square index
+        if (getBit(occupancy, rank * 8 + file))
+        {
+            break;
+        }
+    }
+
+    // Cast an attack ray in the negative file and positive rank direction
+    for (rank = targetRank + 1, file = targetFile - 1; rank < 8 && file >= 0; rank++, file--)
+    {
+        // Set the bit on the attack bitboard
+        setBit(attacksBitboard, rank * 8 + file);
+
+        // Break out the loop if the piece is found at the current square index
+        if (getBit(occupancy, rank * 8 + file))
+        {
+            break;
+        }
+    }
+
+    // Cast an attack ray in the negative file and negative rank direction
+    for (rank = targetRank - 1, file = targetFile - 1; rank >= 0 && file >= 0; rank--, file--)
+    {
+        // Set the bit on the attack bitboard
+        setBit(attacksBitboard, rank * 8 + file);
+
+        // Break out the loop if the piece is found at the current square index
+        if (getBit(occupancy, rank * 8 + file))
+        {
+            break;
+        }
+    }
+
+    return attacksBitboard;
+}
 
 // Dynamically generate rook attack mask for a given occupancy and the square index
-U64 generateRookAttacks(int squareIndex, const U64 &occupancy);
+constexpr U64 generateRookAttacks(int squareIndex, const U64 &occupancy)
+{
+
+    U64 attacksBitboard = 0ULL;
+
+    int rank = 0, file = 0;
+
+    // Get the file and the rank from the square index
+    int targetRank = squareIndex / 8;
+    int targetFile = squareIndex % 8;
+
+    // Cast an attack ray in the positive rank direction
+    for (rank = targetRank + 1; rank < 8; rank++)
+    {
+        // Set the bit on the attack bitboard
+        setBit(attacksBitboard, rank * 8 + targetFile);
+
+        // Break out the loop if the piece is found at the current square index
+        if (getBit(occupancy, rank * 8 + targetFile))
+        {
+            break;
+        }
+    }
+
+    // Cast an attack ray in the negative rank direction
+    for (rank = targetRank - 1; rank >= 0; rank--)
+    {
+        // Set the bit on the attack bitboard
+        setBit(attacksBitboard, rank * 8 + targetFile);
+
+        // Break out the loop if the piece is found at the current square index
+        if (getBit(occupancy, rank * 8 + targetFile))
+        {
+            break;
+        }
+    }
+
+    // Cast an attack ray in the positive file direction
+    for (file = targetFile + 1; file < 8; file++)
+    {
+        // Set the bit on the attack bitboard
+        setBit(attacksBitboard, targetRank * 8 + file);
+
+        // Break out the loop if the piece is found at the current square index
+        if (getBit(occupancy, targetRank * 8 + file))
+        {
+            break;
+        }
+    }
+
+    // Cast an attack ray in the negative file direction
+    for (file = targetFile - 1; file >= 0; file--)
+    {
+        // Set the bit on the attack bitboard
+        setBit(attacksBitboard, targetRank * 8 + file);
+
+        // Break out the loop if the piece is found at the current square index
+        if (getBit(occupancy, targetRank * 8 + file))
+        {
+            break;
+        }
+    }
+
+    return attacksBitboard;
+}
 
 // Generate the occupancy bitboards from the given occupancy index
-U64 getOccupancyFromIndex(int occupancyIndex, int relevantBits, U64 attackMask);
+constexpr U64 getOccupancyFromIndex(int occupancyIndex, int relevantBits, U64 attackMask)
+{
+    U64 bitboard = 0ULL;
+
+    // Loop over the relevant bits of the attack mask
+    for (int currentBit = 0; currentBit < relevantBits; currentBit++)
+    {
+        // Pop the LS1B index from the bitboard
+        int squareIndex = popLSB(attackMask);
+        // If the occupancy index includes the current bit
+        if (occupancyIndex & (1 << currentBit))
+        {
+            // Set the bit on the occupancy bitboard
+            setBit(bitboard, squareIndex);
+        }
+    }
+
+    return bitboard;
+}
 
 // Find a magic number for the given sliding piece and a given
 U64 findMagicNumber(int squareIndex, int relevantBits, bool fBishop);
 
+// Check that the magic number maps every occupancy of the attack mask to an index holding the same attacks
+bool isMagicNumberValid(int squareIndex, int relevantBits, bool fBishop, U64 magicNumber);
+
+// Search for the magic numbers of all of the squares and print them as the constant arrays of const.h
+void printMagicNumbers();
+
 #endif
@@ -1,51 +1,170 @@
 #include <iostream>
+#include <string>
+#include <algorithm>
 
 #include "globals.h"
 #include "random.h"
-#include "Position.h"
-#include "move_encoding.h"
+#include "Board.h"
+#include "SearchThreads.h"
+#include "benchmarks.h"
+#include "NeuralNetwork.h"
+#include "magic_numbers.h"
 #include "const.h"
 
 using std::cout, std::string;
 
-void search(string fenString, int depth)
+void search(string fenString, int depth, int numThreads, const NeuralNetwork *pNetwork)
 {
-    seedRandom();
-    generateKeys();
-    generateEvaluationMasks();
+    Board(fenString).printState();
+
+    SearchThreads threads(numThreads);
+    threads.setNetwork(pNetwork);
+    threads.search(fenString, depth, true);
+}
 
-    Position position(fenString);
-    position.getBoard().printState();
-    position.resetSearchVariables();
+// Load the network file given as the argument, returning null to evaluate with the hand-crafted evaluation if there is none
+const NeuralNetwork *loadNetwork(NeuralNetwork &network, int argc, char *argv[], int argumentIndex)
+{
+    if (argc <= argumentIndex)
+    {
+        return nullptr;
+    }
 
-    int alpha = -INF, beta = INF;
+    network.load(argv[argumentIndex]);
+    return &network;
+}
 
-    for (int currentDepth = 1; currentDepth <= depth; currentDepth++)
+int main(int argc, char *argv[])
+{
+    seedRandom();
+    generateKeys();
+
+    // Usage: ./main --sliders magic|pext|kogge-stone <command> ..., forcing the sliding piece attack backend chosen from the CPU features and the build
+    if (argc > 2 && string(argv[1]) == "--sliders")
     {
-        int score = position.negamax(alpha, beta, currentDepth);
+        const string BACKEND_NAMES[3] = {"magic", "pext", "kogge-stone"};
 
-        if ((score <= alpha) || (score >= beta))
+        string backend = argv[2];
+        int backendIndex = (int)(std::find(BACKEND_NAMES, BACKEND_NAMES + 3, backend) - BACKEND_NAMES);
+
+        if (backendIndex == 3 || !AttackTable::setSliderBackend(backendIndex))
         {
-            alpha = -INF;
-            beta = INF;
-            continue;
+            cout << "Unknown or unsupported slider backend: " << backend << '\n';
+            return 1;
         }
 
-        alpha = score + ASPIRATION_WINDOW;
-        beta = score - ASPIRATION_WINDOW;
+        argc -= 2;
+        argv += 2;
+    }
+
+    string command = (argc > 1) ? argv[1] : "search";
 
-        cout << "\n\nEvaluation: " << score;
-        cout << "\nPrincipled variation: ";
-        position.printPV();
+    // Network chosen on the command line in place of the hand-crafted evaluation
+    NeuralNetwork network;
+
+    // Usage: ./main bench [depth] [hashMB] [evalCacheMB] [network]
+    if (command == "bench")
+    {
+        TRANSPOSITION_TABLE.resize((argc > 3) ? std::stoi(argv[3]) : DEFAULT_TT_MEGABYTES);
+        EVALUATION_CACHE.resize((argc > 4) ? std::stoi(argv[4]) : DEFAULT_EVAL_CACHE_MEGABYTES);
+        benchmarkSearch((argc > 2) ? std::stoi(argv[2]) : 8, loadNetwork(network, argc, argv, 5));
+        return 0;
     }
 
-    cout << "\n\nBest Move: ";
-    printMove(position.getBestMove());
-    cout << "\n";
-}
+    // Usage: ./main perft [depth]
+    if (command == "perft")
+    {
+        benchmarkPerft((argc > 2) ? std::stoi(argv[2]) : 4);
+        return 0;
+    }
 
-int main()
-{
-    search(START_POSITION_FEN, 10);
+    // Usage: ./main makemove [iterations]
+    if (command == "makemove")
+    {
+        benchmarkMakeMove((argc > 2) ? std::stoi(argv[2]) : 1000000);
+        return 0;
+    }
+
+    // Usage: ./main eval [iterations] [network]
+    if (command == "eval")
+    {
+        benchmarkEvaluation((argc > 2) ? std::stoi(argv[2]) : 1000, loadNetwork(network, argc, argv, 3));
+        return 0;
+    }
+
+    // Usage: ./main nnue-export [file]
+    if (command == "nnue-export")
+    {
+        writeBootstrapNetwork((argc > 2) ? argv[2] : DEFAULT_NETWORK_FILE);
+        return 0;
+    }
+
+    // Usage: ./main bitscan [iterations]
+    if (command == "bitscan")
+    {
+        benchmarkBitScans((argc > 2) ? std::stoi(argv[2]) : 1000);
+        return 0;
+    }
+
+    // Usage: ./main sliders [iterations]
+    if (command == "sliders")
+    {
+        benchmarkSliderLookups((argc > 2) ? std::stoi(argv[2]) : 10000);
+        return 0;
+    }
+
+    // Usage: ./main attackmaps [iterations]
+    if (command == "attackmaps")
+    {
+        benchmarkAttackMaps((argc > 2) ? std::stoi(argv[2]) : 10000);
+        return 0;
+    }
+
+    // Usage: ./main prefetch [probes] [hashMB]
+    if (command == "prefetch")
+    {
+        TRANSPOSITION_TABLE.resize((argc > 3) ? std::stoi(argv[3]) : DEFAULT_TT_MEGABYTES);
+        benchmarkHashPrefetch((argc > 2) ? std::stoi(argv[2]) : 10000000);
+        return 0;
+    }
+
+    // Usage: ./main smp [maxThreads] [depth] [hashMB]
+    if (command == "smp")
+    {
+        TRANSPOSITION_TABLE.resize((argc > 4) ? std::stoi(argv[4]) : DEFAULT_TT_MEGABYTES);
+        benchmarkLazySMP((argc > 2) ? std::stoi(argv[2]) : 4, (argc > 3) ? std::stoi(argv[3]) : 8);
+        return 0;
+    }
+
+    // Usage: ./main ttstress [threads] [operations]
+    if (command == "ttstress")
+    {
+        return stressTestTranspositionTable((argc > 2) ? std::stoi(argv[2]) : 16, (argc > 3) ? std::stoi(argv[3]) : 10000000) ? 0 : 1;
+    }
+
+    // Usage: ./main movegen [depth]
+    if (command == "movegen")
+    {
+        return verifyMoveGeneration((argc > 2) ? std::stoi(argv[2]) : 4) ? 0 : 1;
+    }
+
+    // Usage: ./main startup [iterations]
+    if (command == "startup")
+    {
+        benchmarkStartup((argc > 2) ? std::stoi(argv[2]) : 20);
+        return 0;
+    }
+
+    // Usage: ./main magics
+    if (command == "magics")
+    {
+        printMagicNumbers();
+        return 0;
+    }
+
+    // Usage: ./main search [depth] [threads] [hashMB] [evalCacheMB] [network]
+    TRANSPOSITION_TABLE.resize((argc > 4) ? std::stoi(argv[4]) : DEFAULT_TT_MEGABYTES);
+    EVALUATION_CACHE.resize((argc > 5) ? std::stoi(argv[5]) : DEFAULT_EVAL_CACHE_MEGABYTES);
+    search(START_POSITION_FEN, (argc > 2) ? std::stoi(argv[2]) : 10, (argc > 3) ? std::stoi(argv[3]) : 1, loadNetwork(network, argc, argv, 6));
     return 0;
 }
@@ -1,4 +1,5 @@
 #include "AttackTable.h"
+#include "kogge_stone.h"
 #include "bitboard_operations.h"
 #include "engine_exceptions.h"
 #include "magic_numbers.h"
@@ -6,86 +7,66 @@
 #include "const.h"
 #include "enum.h"
 
-// Initialise magic numbers
-void AttackTable::initialiseMagicNumbers()
-{
-    // Loop over the squares
-    for (int squareIndex = 0; squareIndex < 64; squareIndex++)
-    {
-
-        // Initialise magic numbers for bishops
-        bishopMagics[squareIndex] = findMagicNumber(squareIndex, BISHOP_RELEVANT_BITS[squareIndex], true);
+#ifdef PEXT_SLIDERS
+#include <immintrin.h>
 
-        // Initialise magic numbers for rooks
-        rookMagics[squareIndex] = findMagicNumber(squareIndex, ROOK_RELEVANT_BITS[squareIndex], false);
-    }
+// Extract the occupancy bits under the mask into the low bits, only called once the CPU is known to have BMI2
+static inline U64 extractBits(U64 bitboard, U64 mask)
+{
+#if defined(__BMI2__)
+    return _pext_u64(bitboard, mask);
+#else
+    // A portable build may not emit BMI2 code, but the assembler takes the instruction, which keeps the lookup inlined
+    U64 result;
+    asm("pextq %2, %1, %0" : "=r"(result) : "r"(bitboard), "rm"(mask));
+    return result;
+#endif
 }
 
-// Initialise leaping piece attack tables
-void AttackTable::initialiseLeapingPieceTables()
+// Check if the CPU extracts bits in hardware at full speed, which AMD processors before Zen 3 only emulate in microcode
+static bool isPextFast()
 {
-    // Loop over the squares
-    for (int squareIndex = 0; squareIndex < 64; squareIndex++)
-    {
-
-        // Initialise leaping piece attacks
-        pawnAttacks[white][squareIndex] = maskPawnAttacks(squareIndex, white);
-        pawnAttacks[black][squareIndex] = maskPawnAttacks(squareIndex, black);
-        knightAttacks[squareIndex] = maskKnightAttacks(squareIndex);
-        kingAttacks[squareIndex] = maskKingAttacks(squareIndex);
-    }
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2") && !__builtin_cpu_is("znver1") && !__builtin_cpu_is("znver2");
 }
 
-// Initialise sliding piece attack tables
-void AttackTable::initialiseSlidingPieceTables(bool fBishop)
+// Sliding piece attack backend of every attack table, chosen once at startup from the CPU features
+static int sliderBackend = isPextFast() ? pextSliders : magicSliders;
+#elif defined(KOGGE_STONE_SLIDERS)
+static int sliderBackend = koggeStoneSliders;
+#else
+static int sliderBackend = magicSliders;
+#endif
+
+// Select the sliding piece attack backend for every attack table, returning false if the CPU cannot run it
+bool AttackTable::setSliderBackend(int backend)
 {
-    // Check if the magic numbers are initialised
-    if (!bishopMagics[0] || !rookMagics[0])
+#if defined(KOGGE_STONE_SLIDERS)
+    // The build has no attack tables to fall back on
+    if (backend != koggeStoneSliders)
     {
-        throw MagicNumberNotInitialisedException();
+        return false;
     }
-
-    // Loop over the squares
-    for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+#elif defined(PEXT_SLIDERS)
+    if (backend == koggeStoneSliders || (backend == pextSliders && !__builtin_cpu_supports("bmi2")))
     {
+        return false;
+    }
+#else
+    if (backend != magicSliders)
+    {
+        return false;
+    }
+#endif
 
-        // Fill the arrays of masks to fetch attacks later
-        bishopMasks[squareIndex] = maskBishopAttacks(squareIndex);
-        rookMasks[squareIndex] = maskRookAttacks(squareIndex);
-
-        // Assign the attack mask
-        U64 attackMask = fBishop ? bishopMasks[squareIndex] : rookMasks[squareIndex];
-
-        int relevantBits = getPopulationCount(attackMask);
-        int maxOccupancyIndex = 1 << relevantBits;
-
-        // Loop over the occupancy indicies
-        for (int occupancyIndex = 0; occupancyIndex < maxOccupancyIndex; occupancyIndex++)
-        {
-
-            // Get an occupancy bitboard from the current occupancy index
-            U64 occupancy = getOccupancyFromIndex(occupancyIndex, relevantBits, attackMask);
-
-            if (fBishop)
-            {
-
-                // Generate a magicIndex
-                int magicIndex = (occupancy * bishopMagics[squareIndex]) >> (64 - BISHOP_RELEVANT_BITS[squareIndex]);
-
-                // Fill the bishop attacks array
-                bishopAttacks[squareIndex][magicIndex] = generateBishopAttacks(squareIndex, occupancy);
-            }
-            else
-            {
-
-                // Generate a magicIndex
-                int magicIndex = (occupancy * rookMagics[squareIndex]) >> (64 - ROOK_RELEVANT_BITS[squareIndex]);
+    sliderBackend = backend;
+    return true;
+}
 
-                // Fill the rook attacks array
-                rookAttacks[squareIndex][magicIndex] = generateRookAttacks(squareIndex, occupancy);
-            }
-        }
-    }
+// Get the sliding piece attack backend in use
+int AttackTable::getSliderBackend()
+{
+    return sliderBackend;
 }
 
 // Get pawn attacks
@@ -112,25 +93,49 @@ U64 AttackTable::getKingAttacks(int squareIndex) const
 // Get bishop attacks
 U64 AttackTable::getBishopAttacks(int squareIndex, U64 occupancy) const
 {
+#if defined(KOGGE_STONE_SLIDERS)
+    return getBishopSetAttacks(1ULL << squareIndex, occupancy);
+#else
+#ifdef PEXT_SLIDERS
+    // Index the dense table by the occupied squares of the mask, packed into the low bits
+    if (sliderBackend == pextSliders)
+    {
+        return pextAttacks[bishopOffsets[squareIndex] + extractBits(occupancy, bishopMasks[squareIndex])];
+    }
+#endif
+
     // Convert the occupancy into the index of the attack table
     occupancy &= bishopMasks[squareIndex];
-    occupancy *= bishopMagics[squareIndex];
+    occupancy *= BISHOP_MAGIC_NUMBERS[squareIndex];
     occupancy >>= 64 - BISHOP_RELEVANT_BITS[squareIndex];
 
-    // Fetch the attacks
-    return bishopAttacks[squareIndex][occupancy];
+    // Fetch the attacks from the entries of the square
+    return magicAttacks[bishopOffsets[squareIndex] + occupancy];
+#endif
 }
 
 // Get rook attacks
 U64 AttackTable::getRookAttacks(int squareIndex, U64 occupancy) const
 {
+#if defined(KOGGE_STONE_SLIDERS)
+    return getRookSetAttacks(1ULL << squareIndex, occupancy);
+#else
+#ifdef PEXT_SLIDERS
+    // Index the dense table by the occupied squares of the mask, packed into the low bits
+    if (sliderBackend == pextSliders)
+    {
+        return pextAttacks[rookOffsets[squareIndex] + extractBits(occupancy, rookMasks[squareIndex])];
+    }
+#endif
+
     // Convert the occupancy into the index of the attack table
     occupancy &= rookMasks[squareIndex];
-    occupancy *= rookMagics[squareIndex];
+    occupancy *= ROOK_MAGIC_NUMBERS[squareIndex];
     occupancy >>= 64 - ROOK_RELEVANT_BITS[squareIndex];
 
-    // Fetch the attacks
-    return rookAttacks[squareIndex][occupancy];
+    // Fetch the attacks from the entries of the square
+    return magicAttacks[rookOffsets[squareIndex] + occupancy];
+#endif
 }
 
 // Get queen attacks
@@ -139,3 +144,103 @@ U64 AttackTable::getQueenAttacks(int squareIndex, U64 occupancy) const
     // Logical AND on the bishop and rook attacks
     return getBishopAttacks(squareIndex, occupancy) | getRookAttacks(squareIndex, occupancy);
 }
+
+// Get the squares attacked by all of the given pawns at once, shifting the pawns off the edge files away before they wrap
+U64 AttackTable::getPawnSetAttacks(uint color, U64 pawns) const
+{
+    if (color == white)
+    {
+        return ((pawns & NOT_H_FILE) >> 7) | ((pawns & NOT_A_FILE) >> 9);
+    }
+
+    return ((pawns & NOT_H_FILE) << 9) | ((pawns & NOT_A_FILE) << 7);
+}
+
+// Get the squares attacked by all of the given knights at once, with the same shifts as the knight attack masks
+U64 AttackTable::getKnightSetAttacks(U64 knights) const
+{
+    return ((knights & NOT_H_FILE) >> 15) | ((knights & NOT_H_FILE) << 17) |
+           ((knights & NOT_A_FILE) >> 17) | ((knights & NOT_A_FILE) << 15) |
+           ((knights & NOT_HG_FILE) >> 6) | ((knights & NOT_HG_FILE) << 10) |
+           ((knights & NOT_AB_FILE) >> 10) | ((knights & NOT_AB_FILE) << 6);
+}
+
+/*
+Get the squares attacked by all of the given bishops at once, filled as one set in a Kogge-Stone build and looked up piece by piece otherwise.
+The four 64-bit lanes of AVX2 fill every ray of the piece together and beat the scalar fills, which every other target takes.
+*/
+U64 AttackTable::getBishopSetAttacks(U64 bishops, U64 occupancy) const
+{
+#if defined(KOGGE_STONE_SLIDERS) && defined(__AVX2__)
+    return getBishopFillAttacksSimd(bishops, occupancy);
+#elif defined(KOGGE_STONE_SLIDERS)
+    return getBishopFillAttacks(bishops, occupancy);
+#else
+    U64 attacks = 0ULL;
+
+    while (bishops)
+    {
+        attacks |= getBishopAttacks(popLSB(bishops), occupancy);
+    }
+
+    return attacks;
+#endif
+}
+
+// Get the squares attacked by all of the given rooks at once, filled as one set in a Kogge-Stone build and looked up piece by piece otherwise
+U64 AttackTable::getRookSetAttacks(U64 rooks, U64 occupancy) const
+{
+#if defined(KOGGE_STONE_SLIDERS) && defined(__AVX2__)
+    return getRookFillAttacksSimd(rooks, occupancy);
+#elif defined(KOGGE_STONE_SLIDERS)
+    return getRookFillAttacks(rooks, occupancy);
+#else
+    U64 attacks = 0ULL;
+
+    while (rooks)
+    {
+        attacks |= getRookAttacks(popLSB(rooks), occupancy);
+    }
+
+    return attacks;
+#endif
+}
+
+// Get the attacks of the given piece, white or black, from the square
+U64 AttackTable::getPieceAttacks(int piece, int squareIndex, U64 occupancy) const
+{
+    switch (piece % 6)
+    {
+    case pawn:
+        return pawnAttacks[piece / 6][squareIndex];
+    case knight:
+        return knightAttacks[squareIndex];
+    case bishop:
+        return getBishopAttacks(squareIndex, occupancy);
+    case rook:
+        return getRookAttacks(squareIndex, occupancy);
+    case queen:
+        return getQueenAttacks(squareIndex, occupancy);
+    default:
+        return kingAttacks[squareIndex];
+    }
+}
+
+// Get the squares strictly between two squares sharing a rank, file or diagonal, or an empty bitboard if they share none
+U64 AttackTable::getBetweenSquares(int squareIndex1, int squareIndex2) const
+{
+    U64 bitboard1 = 1ULL << squareIndex1, bitboard2 = 1ULL << squareIndex2;
+
+    // With only the two squares occupied, the rays running from each one towards the other meet exactly between them
+    if (getRookAttacks(squareIndex1, 0ULL) & bitboard2)
+    {
+        return getRookAttacks(squareIndex1, bitboard2) & getRookAttacks(squareIndex2, bitboard1);
+    }
+
+    if (getBishopAttacks(squareIndex1, 0ULL) & bitboard2)
+    {
+        return getBishopAttacks(squareIndex1, bitboard2) & getBishopAttacks(squareIndex2, bitboard1);
+    }
+
+    return 0ULL;
+}
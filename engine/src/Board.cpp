@@ -1,20 +1,18 @@
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 
 #include "Board.h"
+#include "EvaluationTables.h"
 #include "bitboard_operations.h"
 #include "engine_exceptions.h"
 
 using std::cout, std::string;
 
-extern AttackTable ATTACKS;
-extern TranspositionNode TRANSPOSITION_TABLE[];
-extern U64 repetitions[];
-extern int repetitionIndex;
-extern U64 fileMasks[];
-extern U64 isolatedPawnMasks[];
-extern U64 whitePassedPawnMasks[];
-extern U64 blackPassedPawnMasks[];
+extern const AttackTable ATTACKS;
+extern const EvaluationTables EVALUATION_TABLES;
+extern TranspositionTable TRANSPOSITION_TABLE;
+extern EvaluationCache EVALUATION_CACHE;
 extern U64 PIECE_KEYS[12][64];
 extern U64 ENPASSANT_KEYS[64];
 extern U64 CASTLING_KEYS[16];
@@ -23,6 +21,11 @@ extern U64 SIDE_KEY;
 void Board::resetBitboards()
 {
     memset(bitboards, 0, sizeof(bitboards));
+
+    for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+    {
+        pieceOn[squareIndex] = NO_PIECE;
+    }
 }
 
 // Clear the occupancy arrays
@@ -53,359 +56,287 @@ void Board::populateOccupancies()
     occupancies[both] = occupancies[white] | occupancies[black];
 }
 
-// Find the heuristic value of the position
-int Board::staticEvaluate()
+// Add the piece on the square to the evaluation accumulators
+inline void Board::addPieceScore(int piece, int squareIndex)
 {
-    // Initialise the variables
-    int score = 0, scoreOpening = 0, scoreEndgame = 0;
-    int squareIndex = 0, doubledPawns = 0, gamePhase = 0;
+    pieceSquareScore[opening] += EVALUATION_TABLES.pieceSquareScore[opening][piece][squareIndex];
+    pieceSquareScore[endgame] += EVALUATION_TABLES.pieceSquareScore[endgame][piece][squareIndex];
+    gameScore += EVALUATION_TABLES.gamePhaseScore[piece];
+}
 
-    // Obtain game score
-    int gameScore = calculateGameScore();
+// Remove the piece on the square from the evaluation accumulators
+inline void Board::removePieceScore(int piece, int squareIndex)
+{
+    pieceSquareScore[opening] -= EVALUATION_TABLES.pieceSquareScore[opening][piece][squareIndex];
+    pieceSquareScore[endgame] -= EVALUATION_TABLES.pieceSquareScore[endgame][piece][squareIndex];
+    gameScore -= EVALUATION_TABLES.gamePhaseScore[piece];
+}
 
-    // If the game score is higher than the opening bound
-    if (gameScore > OPENING_SCORE)
-    {
-        // Set the game phase to the opening
-        gamePhase = opening;
-        // If the game score is lower than the opening bound
-    }
-    else if (gamePhase < ENDGAME_SCORE)
-    {
-        // Set the game phase to the endgame
-        gamePhase = endgame;
-        // Otherwise
-    }
-    else
-    {
-        // Set the game phase to the middlegame
-        gameScore = middlegame;
-    }
+// Calculate the material plus positional scores for the opening and the endgame from scratch
+void Board::calculatePieceSquareScore(int *scores)
+{
+
+    scores[opening] = 0;
+    scores[endgame] = 0;
 
-    // Loop over all of the pieces
     for (int currentPiece = whitePawn; currentPiece <= blackKing; currentPiece++)
     {
 
-        // Fetch the piece bitboard
         U64 currentPieceBitboard = bitboards[currentPiece];
 
-        // While there are bits on the current bitboard
         while (currentPieceBitboard)
         {
 
-            // Add the material scores
-            scoreOpening += MATERIAL_SCORE[opening][currentPiece];
-            scoreEndgame += MATERIAL_SCORE[endgame][currentPiece];
-
-            // Record the position of the piece
-            squareIndex = getLS1BIndex(currentPieceBitboard);
-
-            // Remove the bit from the current piece bitboard
-            popBit(currentPieceBitboard, squareIndex);
-
-            switch (currentPiece)
-            {
-
-            // If the piece is a white pawn
-            case (whitePawn):
-
-                // Add the positional scores
-                scoreOpening += POSITIONAL_SCORE[opening][pawn][squareIndex];
-                scoreEndgame += POSITIONAL_SCORE[endgame][pawn][squareIndex];
-
-                // Count the number of doubled pawns
-                doubledPawns = getPopulationCount(bitboards[whitePawn] & fileMasks[squareIndex % 8]) - 1;
-
-                // If doubled pawns were found
-                if (doubledPawns > 0)
-                {
-
-                    // Apply the doubled pawn penalty
-                    scoreOpening += doubledPawns * DOUBLED_PENALTY_OPENING;
-                    scoreEndgame += doubledPawns * DOUBLED_PENALTY_ENDGAME;
-                }
-
-                // If the isolated pawns were found
-                if (!(bitboards[whitePawn] & isolatedPawnMasks[squareIndex % 8]))
-                {
-
-                    // Apply the isolated pawn penalty
-                    scoreOpening += ISOLATED_PENALTY_OPENING;
-                    scoreEndgame += ISOLATED_PENALTY_ENDGAME;
-                }
-
-                // If a passed pawn was found
-                if (!(bitboards[blackPawn] & whitePassedPawnMasks[squareIndex]))
-                {
-
-                    // Add the passed pawn score
-                    scoreOpening += PP_SCORE[RANKS[squareIndex]];
-                    scoreEndgame += PP_SCORE[RANKS[squareIndex]];
-                }
-
-                break;
-
-            // If the curent piece is a white knight
-            case (whiteKnight):
-
-                // Add the positional score
-                scoreOpening += POSITIONAL_SCORE[opening][knight][squareIndex];
-                scoreEndgame += POSITIONAL_SCORE[endgame][knight][squareIndex];
-
-                break;
+            int squareIndex = popLSB(currentPieceBitboard);
 
-            // If the current piece is a white bishop
-            case (whiteBishop):
-
-                // Add the positional scores
-                scoreOpening += POSITIONAL_SCORE[opening][bishop][squareIndex];
-                scoreEndgame += POSITIONAL_SCORE[endgame][bishop][squareIndex];
-
-                // Apply piece mobility calculations
-                scoreOpening += (getPopulationCount(ATTACKS.getBishopAttacks(squareIndex, occupancies[both])) - BISHOP_VALUE) * BISHOP_MOB_OPENING;
-                scoreEndgame += (getPopulationCount(ATTACKS.getBishopAttacks(squareIndex, occupancies[both])) - BISHOP_VALUE) * BISHOP_MOB_ENDGAME;
-
-                break;
-
-            // If the current piece is a white bishop
-            case (whiteRook):
-
-                // Add the positional scores
-                scoreOpening += POSITIONAL_SCORE[opening][rook][squareIndex];
-                scoreEndgame += POSITIONAL_SCORE[endgame][rook][squareIndex];
-
-                // If the rook occupies a file with only enemy pawns
-                if (!(bitboards[whitePawn] & fileMasks[squareIndex % 8]))
-                {
-                    // Add the semi-open file score
-                    score += SEMI_OPEN_FILE_SCORE;
-                }
-
-                // If the rook occupies a file without any pawns
-                if (!((bitboards[whitePawn] | bitboards[blackPawn]) & fileMasks[squareIndex % 8]))
-                {
-                    // Add the open file score
-                    score += FULL_OPEN_FILE_SCORE;
-                }
-
-                break;
-
-            // If the current piece is a white queen
-            case (whiteQueen):
+            scores[opening] += EVALUATION_TABLES.pieceSquareScore[opening][currentPiece][squareIndex];
+            scores[endgame] += EVALUATION_TABLES.pieceSquareScore[endgame][currentPiece][squareIndex];
+        }
+    }
+}
 
-                // Add the positional score
-                scoreOpening += POSITIONAL_SCORE[opening][queen][squareIndex];
-                scoreEndgame += POSITIONAL_SCORE[endgame][queen][squareIndex];
+#ifdef DEBUG_BUILD
+// Check the incrementally updated evaluation accumulators against a full recalculation
+void Board::verifyEvaluationAccumulators()
+{
 
-                // Apply piece mobility calculations
-                scoreOpening += (getPopulationCount(ATTACKS.getQueenAttacks(squareIndex, occupancies[both])) - QUEEN_VALUE) * QUEEN_MOB_OPENING;
-                scoreOpening += (getPopulationCount(ATTACKS.getQueenAttacks(squareIndex, occupancies[both])) - QUEEN_VALUE) * QUEEN_MOB_ENDGAME;
+    int scores[2];
+    calculatePieceSquareScore(scores);
 
-                break;
+    if (scores[opening] != pieceSquareScore[opening] || scores[endgame] != pieceSquareScore[endgame] || calculateGameScore() != gameScore)
+    {
+        throw EvaluationOutOfSyncException();
+    }
 
-            // If the current piece is a white king
-            case (whiteKing):
+    // Rebuild the pawn key from the pawn bitboards
+    U64 calculatedPawnKey = 0ULL;
 
-                // Add the positional score
-                scoreOpening += POSITIONAL_SCORE[opening][king][squareIndex];
-                scoreEndgame += POSITIONAL_SCORE[endgame][king][squareIndex];
+    for (int currentPiece : {whitePawn, blackPawn})
+    {
 
-                // If the king is on the file with only enemy pawns
-                if (!(bitboards[whitePawn] & fileMasks[squareIndex % 8]))
-                {
-                    // Deduct the semi-open file score
-                    score -= SEMI_OPEN_FILE_SCORE;
-                }
+        U64 currentPieceBitboard = bitboards[currentPiece];
 
-                // If the king is on the file with no pawns
-                if (!((bitboards[whitePawn] | bitboards[blackPawn]) & fileMasks[squareIndex % 8]))
-                {
-                    // Score
-                    score -= FULL_OPEN_FILE_SCORE;
-                }
+        while (currentPieceBitboard)
+        {
 
-                // Add the king safety coefficient
-                scoreOpening += getPopulationCount(ATTACKS.getKingAttacks(squareIndex) & bitboards[whitePawn]) * KING_SAFETY_COEFFICIENT;
-                scoreEndgame += getPopulationCount(ATTACKS.getKingAttacks(squareIndex) & bitboards[whitePawn]) * KING_SAFETY_COEFFICIENT;
+            int squareIndex = popLSB(currentPieceBitboard);
+            calculatedPawnKey ^= PIECE_KEYS[currentPiece][squareIndex];
+        }
+    }
 
-                break;
+    if (calculatedPawnKey != pawnKey)
+    {
+        throw EvaluationOutOfSyncException();
+    }
 
-            // Same working principle for black pieces
-            case (blackPawn):
+    // Refresh the network accumulator from the piece bitboards
+    if (pNetwork)
+    {
+        NNUEAccumulator calculatedAccumulator;
+        pNetwork->refreshAccumulator(calculatedAccumulator, bitboards);
 
-                scoreOpening -= POSITIONAL_SCORE[opening][pawn][OPPOSITE_SIDE[squareIndex]];
-                scoreEndgame -= POSITIONAL_SCORE[endgame][pawn][OPPOSITE_SIDE[squareIndex]];
+        if (std::memcmp(calculatedAccumulator.values, accumulator.values, sizeof(accumulator.values)) != 0)
+        {
+            throw EvaluationOutOfSyncException();
+        }
+    }
+}
 
-                doubledPawns = getPopulationCount(bitboards[blackPawn] & fileMasks[squareIndex % 8]) - 1;
+// Check the cached attack info used by the move generation against a fresh computation
+void Board::verifyAttackInfo(const AttackInfo &info)
+{
 
-                if (doubledPawns > 0)
-                {
+    AttackInfo freshInfo;
+    computeAttacks(freshInfo, sideToMove ^ 1);
+    computeCheckAndPinMasks(freshInfo);
 
-                    scoreOpening -= doubledPawns * DOUBLED_PENALTY_OPENING;
-                    scoreEndgame -= doubledPawns * DOUBLED_PENALTY_ENDGAME;
-                }
+    if (freshInfo.sideAttacks[sideToMove ^ 1] != info.sideAttacks[sideToMove ^ 1] || freshInfo.checkers != info.checkers ||
+        freshInfo.evasionMask != info.evasionMask || freshInfo.kingDanger != info.kingDanger || freshInfo.pinned != info.pinned)
+    {
+        throw AttackInfoOutOfSyncException();
+    }
+}
 
-                if (!(bitboards[blackPawn] & isolatedPawnMasks[squareIndex % 8]))
-                {
+// Check the incrementally updated occupancies against a full rebuild from the piece bitboards
+void Board::verifyOccupancies()
+{
 
-                    scoreOpening -= ISOLATED_PENALTY_OPENING;
-                    scoreEndgame -= ISOLATED_PENALTY_ENDGAME;
-                }
+    U64 incrementalOccupancies[3];
+    memcpy(incrementalOccupancies, occupancies, sizeof(occupancies));
 
-                if (!(bitboards[whitePawn] & blackPassedPawnMasks[squareIndex]))
-                {
+    resetOccupancies();
+    populateOccupancies();
 
-                    scoreOpening -= PP_SCORE[RANKS[OPPOSITE_SIDE[squareIndex]]];
-                    scoreEndgame -= PP_SCORE[RANKS[OPPOSITE_SIDE[squareIndex]]];
-                }
+    if (memcmp(incrementalOccupancies, occupancies, sizeof(occupancies)))
+    {
+        throw OccupanciesOutOfSyncException();
+    }
+}
+#endif
 
-                break;
+// Add the doubled, isolated and passed pawn scores of the given color to the scores of white, collecting its passed pawns
+template <int Color>
+void Board::evaluatePawns(int *scores, U64 &passedPawns)
+{
 
-            case (blackKnight):
+    // Get the pawns of both sides and the sign of the scores of the color as constants
+    constexpr int PAWN = (Color == white) ? whitePawn : blackPawn;
+    constexpr int ENEMY_PAWN = (Color == white) ? blackPawn : whitePawn;
+    constexpr int SIGN = (Color == white) ? 1 : -1;
 
-                scoreOpening -= POSITIONAL_SCORE[opening][knight][OPPOSITE_SIDE[squareIndex]];
-                scoreEndgame -= POSITIONAL_SCORE[endgame][knight][OPPOSITE_SIDE[squareIndex]];
+    const U64 *passedPawnMasks = (Color == white) ? EVALUATION_TABLES.whitePassedPawnMasks : EVALUATION_TABLES.blackPassedPawnMasks;
 
-                break;
+    U64 currentPieceBitboard = bitboards[PAWN];
 
-            case (blackBishop):
+    while (currentPieceBitboard)
+    {
 
-                scoreOpening -= POSITIONAL_SCORE[opening][bishop][OPPOSITE_SIDE[squareIndex]];
-                scoreEndgame -= POSITIONAL_SCORE[endgame][bishop][OPPOSITE_SIDE[squareIndex]];
+        int squareIndex = popLSB(currentPieceBitboard);
 
-                scoreOpening -= (getPopulationCount(ATTACKS.getBishopAttacks(squareIndex, occupancies[both])) - BISHOP_VALUE) * BISHOP_MOB_OPENING;
-                scoreEndgame -= (getPopulationCount(ATTACKS.getBishopAttacks(squareIndex, occupancies[both])) - BISHOP_VALUE) * BISHOP_MOB_ENDGAME;
+        // Count the number of doubled pawns
+        int doubledPawns = getPopulationCount(bitboards[PAWN] & EVALUATION_TABLES.fileMasks[squareIndex % 8]) - 1;
 
-                break;
+        // If doubled pawns were found
+        if (doubledPawns > 0)
+        {
 
-            case (blackRook):
+            // Apply the doubled pawn penalty
+            scores[opening] += SIGN * doubledPawns * DOUBLED_PENALTY_OPENING;
+            scores[endgame] += SIGN * doubledPawns * DOUBLED_PENALTY_ENDGAME;
+        }
 
-                scoreOpening -= POSITIONAL_SCORE[opening][rook][OPPOSITE_SIDE[squareIndex]];
-                scoreEndgame -= POSITIONAL_SCORE[endgame][rook][OPPOSITE_SIDE[squareIndex]];
+        // If the isolated pawns were found
+        if (!(bitboards[PAWN] & EVALUATION_TABLES.isolatedPawnMasks[squareIndex % 8]))
+        {
 
-                if (!(bitboards[blackPawn] & fileMasks[squareIndex % 8]))
-                {
-                    score -= SEMI_OPEN_FILE_SCORE;
-                }
+            // Apply the isolated pawn penalty
+            scores[opening] += SIGN * ISOLATED_PENALTY_OPENING;
+            scores[endgame] += SIGN * ISOLATED_PENALTY_ENDGAME;
+        }
 
-                if (!((bitboards[whitePawn] | bitboards[blackPawn]) & fileMasks[squareIndex % 8]))
-                {
-                    score -= FULL_OPEN_FILE_SCORE;
-                }
+        // If a passed pawn was found
+        if (!(bitboards[ENEMY_PAWN] & passedPawnMasks[squareIndex]))
+        {
 
-                break;
+            // Add the passed pawn score by the rank counted from the side of the color
+            int rank = RANKS[(Color == white) ? squareIndex : OPPOSITE_SIDE[squareIndex]];
 
-            case (blackQueen):
+            scores[opening] += SIGN * PP_SCORE[rank];
+            scores[endgame] += SIGN * PP_SCORE[rank];
+            setBit(passedPawns, squareIndex);
+        }
+    }
+}
 
-                scoreOpening -= POSITIONAL_SCORE[opening][queen][OPPOSITE_SIDE[squareIndex]];
-                scoreEndgame -= POSITIONAL_SCORE[endgame][queen][OPPOSITE_SIDE[squareIndex]];
+// Calculate the doubled, isolated and passed pawn scores from scratch, collecting the passed pawns of both sides
+void Board::evaluatePawns(int *scores, U64 *passedPawns)
+{
 
-                scoreOpening -= (getPopulationCount(ATTACKS.getQueenAttacks(squareIndex, occupancies[both])) - QUEEN_VALUE) * QUEEN_MOB_OPENING;
-                scoreOpening -= (getPopulationCount(ATTACKS.getQueenAttacks(squareIndex, occupancies[both])) - QUEEN_VALUE) * QUEEN_MOB_ENDGAME;
+    scores[opening] = 0;
+    scores[endgame] = 0;
+    passedPawns[white] = 0ULL;
+    passedPawns[black] = 0ULL;
 
-                break;
+    evaluatePawns<white>(scores, passedPawns[white]);
+    evaluatePawns<black>(scores, passedPawns[black]);
+}
 
-            case (blackKing):
+// Add the mobility, open file and king shield scores of the pieces of the given color to the scores of white
+template <int Color>
+void Board::evaluatePieces(const AttackInfo &info, U64 pawnFiles, int *scores, int &score)
+{
 
-                scoreOpening -= POSITIONAL_SCORE[opening][king][OPPOSITE_SIDE[squareIndex]];
-                scoreEndgame -= POSITIONAL_SCORE[endgame][king][OPPOSITE_SIDE[squareIndex]];
+    // Get the pieces and the sign of the scores of the color as constants
+    constexpr int PAWN = (Color == white) ? whitePawn : blackPawn;
+    constexpr int SIGN = (Color == white) ? 1 : -1;
 
-                if (!(bitboards[whitePawn] & fileMasks[squareIndex % 8]))
-                {
-                    score += SEMI_OPEN_FILE_SCORE;
-                }
+    // Apply the bishop and queen mobility from the attack maps, summed over the pieces of each type
+    int mobility = info.mobility[PAWN + bishop] - getPopulationCount(bitboards[PAWN + bishop]) * BISHOP_VALUE;
+    scores[opening] += SIGN * mobility * BISHOP_MOB_OPENING;
+    scores[endgame] += SIGN * mobility * BISHOP_MOB_ENDGAME;
 
-                if (!((bitboards[whitePawn] | bitboards[blackPawn]) & fileMasks[squareIndex % 8]))
-                {
-                    score += FULL_OPEN_FILE_SCORE;
-                }
+    mobility = info.mobility[PAWN + queen] - getPopulationCount(bitboards[PAWN + queen]) * QUEEN_VALUE;
+    scores[opening] += SIGN * mobility * QUEEN_MOB_OPENING;
+    scores[endgame] += SIGN * mobility * QUEEN_MOB_ENDGAME;
 
-                scoreOpening -= getPopulationCount(ATTACKS.getKingAttacks(squareIndex) & bitboards[blackPawn]) * KING_SAFETY_COEFFICIENT;
-                scoreEndgame -= getPopulationCount(ATTACKS.getKingAttacks(squareIndex) & bitboards[blackPawn]) * KING_SAFETY_COEFFICIENT;
+    // Get the files with pawns of the color
+    U64 ownPawnFiles = getFileFill(bitboards[PAWN]);
 
-                break;
-            }
-        }
-    }
+    // Add the semi-open file score for the rooks on files with only enemy pawns and the open file score for the rooks on files without any pawns
+    score += SIGN * getPopulationCount(bitboards[PAWN + rook] & ~ownPawnFiles) * SEMI_OPEN_FILE_SCORE;
+    score += SIGN * getPopulationCount(bitboards[PAWN + rook] & ~pawnFiles) * FULL_OPEN_FILE_SCORE;
 
-    // Interpolate the scores
-    if (gamePhase == middlegame)
-    {
-        score = (scoreOpening * gameScore + scoreEndgame * (OPENING_SCORE - gameScore)) / OPENING_SCORE;
-    }
-    else if (gamePhase == opening)
+    // Deduct the same scores for a king on such files
+    if (bitboards[PAWN + king] & ~ownPawnFiles)
     {
-        score = scoreOpening;
+        score -= SIGN * SEMI_OPEN_FILE_SCORE;
     }
-    else if (gamePhase == endgame)
+
+    if (bitboards[PAWN + king] & ~pawnFiles)
     {
-        score = scoreEndgame;
+        score -= SIGN * FULL_OPEN_FILE_SCORE;
     }
 
-    // In negamax the score is evaluated relative to the side
-    return (sideToMove == white) ? score : -score;
+    // Add the king safety coefficient for the pawns next to the king
+    int kingShield = getPopulationCount(info.pieceAttacks[PAWN + king] & bitboards[PAWN]) * KING_SAFETY_COEFFICIENT;
+    scores[opening] += SIGN * kingShield;
+    scores[endgame] += SIGN * kingShield;
 }
 
+// Find the heuristic value of the position
+int Board::staticEvaluate()
+{
+    // Initialise the variables, starting from the incrementally updated material and positional scores
+    int score = 0, scores[2] = {pieceSquareScore[opening], pieceSquareScore[endgame]};
 
+    // Weight of the opening score, from 0 once the game score falls to the endgame bound up to PHASE_RANGE at the opening bound
+    int phase = std::min(std::max(gameScore - ENDGAME_SCORE, 0), PHASE_RANGE);
 
+    // Add the pawn structure scores, which only change when a pawn moves and are looked up by the pawn key when possible
+    if (pPawnTable)
+    {
+        bool fHit;
+        PawnHashEntry *pEntry = pPawnTable->probe(pawnKey, fHit);
 
+        if (!fHit)
+        {
+            evaluatePawns(pEntry->score, pEntry->passedPawns);
+            pEntry->pawnKey = pawnKey;
+        }
 
-
-
-
-
-
-
-
-
-
-
-bool Board::isSquareAttacked(int squareIndex, int sideToMove)
-{
-
-    // Return true if the square is attacked by pawns
-    if (sideToMove == white && ATTACKS.getPawnAttacks(black, squareIndex) & bitboards[whitePawn])
-    {
-        return true;
+        scores[opening] += pEntry->score[opening];
+        scores[endgame] += pEntry->score[endgame];
     }
-
-    // Return true if the square is attacked by pawns
-    if (sideToMove == black && ATTACKS.getPawnAttacks(white, squareIndex) & bitboards[blackPawn])
+    else
     {
-        return true;
-    }
+        int pawnScores[2];
+        U64 passedPawns[2];
 
-    // Return true if the square is attacked by the knight
-    if (ATTACKS.getKnightAttacks(squareIndex) & ((sideToMove == white) ? bitboards[whiteKnight] : bitboards[blackKnight]))
-    {
-        return true;
-    }
+        evaluatePawns(pawnScores, passedPawns);
 
-    // Return true if the square is attacked by the bishop
-    if (ATTACKS.getBishopAttacks(squareIndex, occupancies[both]) & ((sideToMove == white) ? bitboards[whiteBishop] : bitboards[blackBishop]))
-    {
-        return true;
+        scores[opening] += pawnScores[opening];
+        scores[endgame] += pawnScores[endgame];
     }
 
-    // Return true if the square is attacked by the rook
-    if (ATTACKS.getRookAttacks(squareIndex, occupancies[both]) & ((sideToMove == white) ? bitboards[whiteRook] : bitboards[blackRook]))
-    {
-        return true;
-    }
+    // Add the piece scores of each side from the attack maps and the files with pawns of either color
+    getAttacks(white);
+    const AttackInfo &info = getAttacks(black);
+    U64 pawnFiles = getFileFill(bitboards[whitePawn] | bitboards[blackPawn]);
 
-    // Return true if the square is attacked by the queen
-    if (ATTACKS.getQueenAttacks(squareIndex, occupancies[both]) & ((sideToMove == white) ? bitboards[whiteQueen] : bitboards[blackQueen]))
-    {
-        return true;
-    }
+    evaluatePieces<white>(info, pawnFiles, scores, score);
+    evaluatePieces<black>(info, pawnFiles, scores, score);
 
-    // Return true if the square is attacked by the king
-    if (ATTACKS.getKingAttacks(squareIndex) & ((sideToMove == white) ? bitboards[whiteKing] : bitboards[blackKing]))
-    {
-        return true;
-    }
+    // Blend the opening and endgame scores by the game phase, on top of the terms that do not depend on it
+    score += (scores[opening] * phase + scores[endgame] * (PHASE_RANGE - phase)) / PHASE_RANGE;
 
-    return false;
+    // In negamax the score is evaluated relative to the side
+    return (sideToMove == white) ? score : -score;
+}
+
+// Check if the square is attacked by the given side
+bool Board::isSquareAttacked(int squareIndex, int sideToMove)
+{
+    return getAttackers(squareIndex, sideToMove, occupancies[both]) != 0ULL;
 }
 
 void Board::generateHash()
@@ -427,12 +358,16 @@ void Board::generateHash()
         while (currentBiboard)
         {
 
-            // Get the square index
-            int squareIndex = getLS1BIndex(currentBiboard);
+            // Pop the square index
+            int squareIndex = popLSB(currentBiboard);
             // Add the value to the hash key
             hashKey ^= PIECE_KEYS[currentPiece][squareIndex];
-            // Remove the bit
-            popBit(currentBiboard, squareIndex);
+
+            // Pawns are also added to the pawn key
+            if (currentPiece == whitePawn || currentPiece == blackPawn)
+            {
+                pawnKey ^= PIECE_KEYS[currentPiece][squareIndex];
+            }
         }
     }
 
@@ -509,486 +444,522 @@ void Board::printState()
     cout << "Hash: " << hashKey << "\n";
 };
 
-// Generate the list of all pseudo-legal moves in a position
-MoveList Board::generateMoves()
+// Get the pieces of the given side attacking the square, with the given occupancy blocking the sliding pieces
+U64 Board::getAttackers(int squareIndex, int side, U64 occupancy)
 {
 
-    // Initialise the start and target square indicies
-    int startSquareIndex, targetSquareIndex;
-    // Initialise the bitboar of the current piece and the bitboards of its attacks
-    U64 currentPieceBitboard, currentPieceAttacks;
-    // Initialise the move list where all of the moves are added
-    MoveList output;
+    int pawnOffset = (side == white) ? whitePawn : blackPawn;
 
-    // Loop over the pieces
-    for (int currentPiece = whitePawn; currentPiece <= blackKing; currentPiece++)
+    return (ATTACKS.getPawnAttacks(side ^ 1, squareIndex) & bitboards[pawnOffset]) |
+           (ATTACKS.getKnightAttacks(squareIndex) & bitboards[pawnOffset + knight]) |
+           (ATTACKS.getBishopAttacks(squareIndex, occupancy) & (bitboards[pawnOffset + bishop] | bitboards[pawnOffset + queen])) |
+           (ATTACKS.getRookAttacks(squareIndex, occupancy) & (bitboards[pawnOffset + rook] | bitboards[pawnOffset + queen])) |
+           (ATTACKS.getKingAttacks(squareIndex) & bitboards[pawnOffset + king]);
+}
+
+// Fill the attack maps of the given side in the attack info
+void Board::computeAttacks(AttackInfo &info, int side)
+{
+
+    int pawnOffset = (side == white) ? whitePawn : blackPawn;
+
+    // The leaping pieces are handled as whole sets, which needs no loop over the pieces
+    info.pieceAttacks[pawnOffset] = ATTACKS.getPawnSetAttacks(side, bitboards[pawnOffset]);
+    info.pieceAttacks[pawnOffset + knight] = ATTACKS.getKnightSetAttacks(bitboards[pawnOffset + knight]);
+    info.pieceAttacks[pawnOffset + king] = ATTACKS.getKingAttacks(getLS1BIndex(bitboards[pawnOffset + king]));
+
+    // The rooks count no mobility, so they are handled as a whole set as well, which a Kogge-Stone build fills in one pass
+    info.pieceAttacks[pawnOffset + rook] = ATTACKS.getRookSetAttacks(bitboards[pawnOffset + rook], occupancies[both]);
+    info.mobility[pawnOffset + rook] = 0;
+
+    // The bishops and queens are looked up one by one, counting their mobility on the way
+    for (int currentPiece : {pawnOffset + bishop, pawnOffset + queen})
     {
 
-        // Copy the bitboard of the current piece
-        currentPieceBitboard = bitboards[currentPiece];
+        U64 currentPieceBitboard = bitboards[currentPiece];
+        U64 attacks = 0ULL;
+        int mobility = 0;
 
-        // If it is white's turn
-        if (sideToMove == white)
+        while (currentPieceBitboard)
         {
 
-            switch (currentPiece)
-            {
+            int squareIndex = popLSB(currentPieceBitboard);
+            U64 pieceAttacks = ATTACKS.getPieceAttacks(currentPiece, squareIndex, occupancies[both]);
 
-            // If the current piece is a white pawn
-            case whitePawn:
+            attacks |= pieceAttacks;
+            mobility += getPopulationCount(pieceAttacks);
+        }
 
-                // While there are bits on the current piece bitboard
-                while (currentPieceBitboard)
-                {
+        info.pieceAttacks[currentPiece] = attacks;
+        info.mobility[currentPiece] = mobility;
+    }
 
-                    // Get the start square index
-                    startSquareIndex = getLS1BIndex(currentPieceBitboard);
+    info.sideAttacks[side] = info.pieceAttacks[pawnOffset] | info.pieceAttacks[pawnOffset + knight] | info.pieceAttacks[pawnOffset + bishop] |
+                             info.pieceAttacks[pawnOffset + rook] | info.pieceAttacks[pawnOffset + queen] | info.pieceAttacks[pawnOffset + king];
+}
 
-                    // Apply an offset (up one rank)
-                    targetSquareIndex = startSquareIndex - 8;
+/*
+Fill the checkers, the squares on which the pieces other than the king resolve a check and the squares the king may not step on:
+the evasion mask holds every square if the king is not in check, the checker and the squares between it and the king
+on a single check and no square on a double check.
+The pieces pinned to the king are collected as well, each with the line it may still move along in pinRays.
+*/
+void Board::computeCheckAndPinMasks(AttackInfo &info)
+{
 
-                    // If the target square is in the board and empty
-                    if (!(targetSquareIndex < a8) && !getBit(occupancies[both], targetSquareIndex))
-                    {
+    int kingSquareIndex = getLS1BIndex(bitboards[(sideToMove == white) ? whiteKing : blackKing]);
+    int enemyPawn = (sideToMove == white) ? blackPawn : whitePawn;
 
-                        // If start square is on the 7th rank
-                        if (startSquareIndex >= a7 && startSquareIndex <= h7)
-                        {
-
-                            // Loop over the possible promotions
-                            for (int promotedPiece = whiteKnight; promotedPiece <= whiteQueen; promotedPiece++)
-                            {
-                                // Add the promotion move to the move list
-                                output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, promotedPiece, 0, 0, 0, 0);
-                            }
-
-                            // If the start square is not on the 7th rank
-                        }
-                        else
-                        {
-
-                            // Add the standard pawn to the move list
-                            output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 0, 0, 0, 0);
-
-                            // If the start square is on the 2nd rank
-                            if ((startSquareIndex >= a2 && startSquareIndex <= h2) && !getBit(occupancies[both], targetSquareIndex - 8))
-                            {
-                                // Add the double pawn push to the move list
-                                output.appendMove(startSquareIndex, targetSquareIndex - 8, currentPiece, 0, 0, 1, 0, 0);
-                            }
-                        }
-                    }
+    // Find the enemy sliding pieces that see the king when only the enemy pieces block them
+    U64 snipers = (ATTACKS.getBishopAttacks(kingSquareIndex, occupancies[sideToMove ^ 1]) & (bitboards[enemyPawn + bishop] | bitboards[enemyPawn + queen])) |
+                  (ATTACKS.getRookAttacks(kingSquareIndex, occupancies[sideToMove ^ 1]) & (bitboards[enemyPawn + rook] | bitboards[enemyPawn + queen]));
 
-                    // Get the attacks of the pawn
-                    currentPieceAttacks = ATTACKS.getPawnAttacks(white, startSquareIndex) & occupancies[black];
+    info.pinned = 0ULL;
 
-                    // While there are bits on the attacks bitboard
-                    while (currentPieceAttacks)
-                    {
+    while (snipers)
+    {
 
-                        // Get the target square index
-                        targetSquareIndex = getLS1BIndex(currentPieceAttacks);
-
-                        // If the pawn is on the 7th rank,
-                        if (startSquareIndex >= a7 && startSquareIndex <= h7)
-                        {
-
-                            // Loop over the possible promotions
-                            for (int promotedPiece = whiteKnight; promotedPiece <= whiteQueen; promotedPiece++)
-                            {
-                                // Add the promotion move to the move list
-                                output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, promotedPiece, 1, 0, 0, 0);
-                            }
-
-                            // If the pawn is not on the 7th rank
-                        }
-                        else
-                        {
-                            // Add the standard pawn capture to the move list
-                            output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 1, 0, 0, 0);
-                        }
-
-                        // Remove the LS1B from the attacks biboard
-                        popBit(currentPieceAttacks, targetSquareIndex);
-                    }
+        int sniperSquareIndex = popLSB(snipers);
 
-                    // If en passant is possible
-                    if (enPassantSquareIndex != NO_SQUARE_INDEX)
-                    {
+        U64 line = ATTACKS.getBetweenSquares(kingSquareIndex, sniperSquareIndex);
+        U64 blockers = line & occupancies[sideToMove];
 
-                        // Get the square index of the possible en passant capture
-                        U64 enPassantAttacks = ATTACKS.getPawnAttacks(white, startSquareIndex) & (1ULL << enPassantSquareIndex);
+        // A single own piece on the line is pinned, and it may only move along the line or capture the sniper
+        if (blockers && !(blockers & (blockers - 1)))
+        {
+            info.pinned |= blockers;
+            info.pinRays[getLS1BIndex(blockers)] = line | (1ULL << sniperSquareIndex);
+        }
+    }
 
-                        // If the square was found
-                        if (enPassantAttacks)
-                        {
+    // Get the pieces giving the check
+    info.checkers = getAttackers(kingSquareIndex, sideToMove ^ 1, occupancies[both]);
+    info.kingDanger = info.sideAttacks[sideToMove ^ 1];
 
-                            // Initialise the target square
-                            int enPassantTarget = getLS1BIndex(enPassantAttacks);
+    // If the king is not in check, every square is allowed
+    if (!info.checkers)
+    {
+        info.evasionMask = ~0ULL;
+        return;
+    }
 
-                            // Add the en passant capture to the move list
-                            output.appendMove(startSquareIndex, enPassantTarget, currentPiece, 0, 1, 0, 1, 0);
-                        }
-                    }
+    // A sliding checker also attacks the squares behind the king, as the king must not step back along its line
+    U64 sliderCheckers = info.checkers & ~(bitboards[enemyPawn] | bitboards[enemyPawn + knight]);
+    U64 kingOccupancy = occupancies[both] ^ (1ULL << kingSquareIndex);
 
-                    // Remove a bit from the current piece bitboard
-                    popBit(currentPieceBitboard, startSquareIndex);
-                }
+    while (sliderCheckers)
+    {
 
-                break;
+        int checkerSquareIndex = popLSB(sliderCheckers);
 
-            // If the current piece is a white king
-            case whiteKing:
+        info.kingDanger |= ATTACKS.getPieceAttacks(pieceOn[checkerSquareIndex], checkerSquareIndex, kingOccupancy);
+    }
 
-                // If kingside castling is avaliable
-                if (canCastle & K)
-                {
-                    // If the squares between the king and the rook are niether occupied and nor attacked
-                    if (!getBit(occupancies[both], f1) && !getBit(occupancies[both], g1) && !isSquareAttacked(e1, black) && !isSquareAttacked(f1, black))
-                    {
-                        // Add the kingside castling to the move list
-                        output.appendMove(e1, g1, currentPiece, 0, 0, 0, 0, 1);
-                    }
-                }
+    // If there are two checkers, only the king can move
+    if (info.checkers & (info.checkers - 1))
+    {
+        info.evasionMask = 0ULL;
+        return;
+    }
 
-                // If queenside castling is avaliable
-                if (canCastle & Q)
-                {
-                    // If the squares between the king and the rook are niether occupied nor attacked
-                    if (!getBit(occupancies[both], d1) && !getBit(occupancies[both], c1) && !getBit(occupancies[both], b1) && !isSquareAttacked(e1, black) && !isSquareAttacked(d1, black))
-                    {
-                        // Add the queenside casting to the move list
-                        output.appendMove(e1, c1, currentPiece, 0, 0, 0, 0, 1);
-                    }
-                }
+    // A single check is resolved by capturing the checker or by blocking the line of a sliding checker
+    info.evasionMask = info.checkers | ATTACKS.getBetweenSquares(kingSquareIndex, getLS1BIndex(info.checkers));
+}
 
-                break;
-            }
+// Check if the en passant capture leaves the king safe once both pawns have left their squares
+bool Board::isEnPassantLegal(int startSquareIndex, int kingSquareIndex)
+{
+
+    int enemyPawn = (sideToMove == white) ? blackPawn : whitePawn;
+    int capturedSquareIndex = enPassantSquareIndex + ((sideToMove == white) ? 8 : -8);
+
+    U64 occupancy = occupancies[both] ^ (1ULL << startSquareIndex) ^ (1ULL << enPassantSquareIndex) ^ (1ULL << capturedSquareIndex);
+
+    // Only a sliding piece can be uncovered, including along the rank both pawns leave
+    return !(ATTACKS.getBishopAttacks(kingSquareIndex, occupancy) & (bitboards[enemyPawn + bishop] | bitboards[enemyPawn + queen])) &&
+           !(ATTACKS.getRookAttacks(kingSquareIndex, occupancy) & (bitboards[enemyPawn + rook] | bitboards[enemyPawn + queen]));
+}
+
+// Generate the moves of a piece type of the side to move onto the target squares, a pinned piece only moving along its pin
+template <int Piece>
+void Board::generatePieceMoves(MoveList &output, U64 targets, const AttackInfo &info)
+{
 
-            // If it is black's turn
+    // Get the pieces of the other side, which the moves capture
+    constexpr int ENEMY = (Piece < blackPawn) ? black : white;
+
+    U64 pieceBitboard = bitboards[Piece];
+
+    while (pieceBitboard)
+    {
+
+        int startSquareIndex = popLSB(pieceBitboard);
+        U64 attacks;
+
+        // Select the attack lookup of the piece type at compile time
+        if constexpr (Piece % 6 == knight)
+        {
+            attacks = ATTACKS.getKnightAttacks(startSquareIndex);
         }
-        else if (sideToMove == black)
+        else if constexpr (Piece % 6 == bishop)
         {
+            attacks = ATTACKS.getBishopAttacks(startSquareIndex, occupancies[both]);
+        }
+        else if constexpr (Piece % 6 == rook)
+        {
+            attacks = ATTACKS.getRookAttacks(startSquareIndex, occupancies[both]);
+        }
+        else if constexpr (Piece % 6 == queen)
+        {
+            attacks = ATTACKS.getQueenAttacks(startSquareIndex, occupancies[both]);
+        }
+        else
+        {
+            attacks = ATTACKS.getKingAttacks(startSquareIndex);
+        }
 
-            switch (currentPiece)
-            {
+        attacks &= targets;
 
-            // If the current piece is a black pawn
-            case blackPawn:
+        // A pinned piece can only move along the pin, which leaves a pinned knight without moves
+        if (getBit(info.pinned, startSquareIndex))
+        {
+            attacks &= info.pinRays[startSquareIndex];
+        }
 
-                // While there are bits on the current piece bitboard
-                while (currentPieceBitboard)
-                {
+        while (attacks)
+        {
+            int targetSquareIndex = popLSB(attacks);
+            output.appendMove(startSquareIndex, targetSquareIndex, Piece, 0, getBit(occupancies[ENEMY], targetSquareIndex), 0, 0, 0);
+        }
+    }
+}
 
-                    // Get the start square index
-                    startSquareIndex = getLS1BIndex(currentPieceBitboard);
+// Generate the legal moves of the given type for the side to move, with its color fixed at compile time
+template <int Color, int GenType>
+void Board::generate(MoveList &output)
+{
 
-                    // Apply an offset (down one rank)
-                    targetSquareIndex = startSquareIndex + 8;
+    // Get the pieces of the side to move and the colour-dependent squares as constants
+    constexpr int ENEMY = Color ^ 1;
+    constexpr int PAWN = (Color == white) ? whitePawn : blackPawn;
+    constexpr int KNIGHT = PAWN + knight, BISHOP = PAWN + bishop, ROOK = PAWN + rook, QUEEN = PAWN + queen, KING = PAWN + king;
 
-                    // If the target square is in the board and empty
-                    if (!(targetSquareIndex > h1) && !getBit(occupancies[both], targetSquareIndex))
-                    {
+    // Offset of a pawn push, the rank the pawns promote from and the rank they push two squares from
+    constexpr int PUSH = (Color == white) ? -8 : 8;
+    constexpr U64 PROMOTION_RANK = (Color == white) ? 0x000000000000FF00ULL : 0x00FF000000000000ULL;
+    constexpr U64 DOUBLE_PUSH_RANK = (Color == white) ? 0x00FF000000000000ULL : 0x000000000000FF00ULL;
 
-                        // If the start square is on the 2nd rank
-                        if (startSquareIndex >= a2 && startSquareIndex <= h2)
-                        {
-
-                            // Loop over the possible promotions
-                            for (int promotedPiece = blackKnight; promotedPiece <= blackQueen; promotedPiece++)
-                            {
-                                // Add the promotion move to the move list
-                                output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, promotedPiece, 0, 0, 0, 0);
-                            }
-
-                            // If the start square is not on the 2nd rank
-                        }
-                        else
-                        {
-
-                            // Add the standard pawn to the move list
-                            output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 0, 0, 0, 0);
-
-                            // If start square is on the 7th rank
-                            if ((startSquareIndex >= a7 && startSquareIndex <= h7) && !getBit(occupancies[both], targetSquareIndex + 8))
-                            {
-                                // Add the double pawn push to the move list
-                                output.appendMove(startSquareIndex, targetSquareIndex + 8, currentPiece, 0, 0, 1, 0, 0);
-                            }
-                        }
-                    }
+    // Castling rights, the squares of the king and the squares which must be empty and the ones which must not be attacked
+    constexpr int KINGSIDE = (Color == white) ? K : k, QUEENSIDE = (Color == white) ? Q : q;
+    constexpr int KING_START = (Color == white) ? e1 : e8;
+    constexpr int KINGSIDE_TARGET = (Color == white) ? g1 : g8, QUEENSIDE_TARGET = (Color == white) ? c1 : c8;
+    constexpr U64 KINGSIDE_EMPTY = (Color == white) ? (1ULL << f1) | (1ULL << g1) : (1ULL << f8) | (1ULL << g8);
+    constexpr U64 QUEENSIDE_EMPTY = (Color == white) ? (1ULL << d1) | (1ULL << c1) | (1ULL << b1) : (1ULL << d8) | (1ULL << c8) | (1ULL << b8);
+    constexpr U64 QUEENSIDE_SAFE = (Color == white) ? (1ULL << d1) | (1ULL << c1) : (1ULL << d8) | (1ULL << c8);
 
-                    // Get the attacks of the pawn
-                    currentPieceAttacks = ATTACKS.getPawnAttacks(black, startSquareIndex) & occupancies[white];
+    // Get the king of the side to move, the squares the other pieces may move to and the pieces pinned to the king
+    int kingSquareIndex = getLS1BIndex(bitboards[KING]);
+    const AttackInfo &info = getCheckAndPinMasks();
+    U64 evasionMask = info.evasionMask;
 
-                    // While there are bits on the attacks bitboard
-                    while (currentPieceAttacks)
-                    {
+#ifdef DEBUG_BUILD
+    verifyAttackInfo(info);
+#endif
 
-                        // Get the target square index
-                        targetSquareIndex = getLS1BIndex(currentPieceAttacks);
-
-                        // If the start square is on the 2nd rank
-                        if (startSquareIndex >= a2 && startSquareIndex <= h2)
-                        {
-
-                            // Loop over the possible promotions
-                            for (int promotedPiece = blackKnight; promotedPiece <= blackQueen; promotedPiece++)
-                            {
-                                // Add the promotion move to the move list
-                                output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, promotedPiece, 1, 0, 0, 0);
-                            }
-
-                            // If the start square is not on the 2nd rank
-                        }
-                        else
-                        {
-                            // Add the promotion move to the move list
-                            output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 1, 0, 0, 0);
-                        }
-
-                        // Remove the LS1B from the attacks biboard
-                        popBit(currentPieceAttacks, targetSquareIndex);
-                    }
+    // Get the squares the moves may capture on and the squares the quiet moves may go to
+    U64 captureTargets = (GenType != quietMoves) ? occupancies[ENEMY] : 0ULL;
+    U64 quietTargets = (GenType != captureMoves) ? ~occupancies[both] : 0ULL;
 
-                    // If en passant is possible
-                    if (enPassantSquareIndex != NO_SQUARE_INDEX)
-                    {
+    // Queen promotions are generated with the captures, the underpromotions with the quiet moves
+    U64 queenPromotionTargets = (GenType != quietMoves) ? ~occupancies[both] : 0ULL;
 
-                        // Get the square index of the possible en passant capture
-                        U64 enPassantAttacks = ATTACKS.getPawnAttacks(black, startSquareIndex) & (1ULL << enPassantSquareIndex);
+    // The king escapes a check by itself, so only its moves ignore the evasion mask, but it may never step on an attacked square
+    U64 kingTargets = (captureTargets | quietTargets) & ~info.kingDanger;
 
-                        // If the square was found
-                        if (enPassantAttacks)
-                        {
+    captureTargets &= evasionMask;
+    quietTargets &= evasionMask;
+    queenPromotionTargets &= evasionMask;
 
-                            // Initialise the target square
-                            int enPassantTarget = getLS1BIndex(enPassantAttacks);
+    // Castling is a quiet move and is never an evasion
+    bool fCastling = quietTargets && evasionMask == ~0ULL;
 
-                            // Add the en passant capture to the move list
-                            output.appendMove(startSquareIndex, enPassantTarget, currentPiece, 0, 1, 0, 1, 0);
-                        }
-                    }
+    // En passant is a capture, which resolves a check if it takes the checking pawn or blocks the checking slider,
+    // and whose remaining legality is checked per move
+    bool fEnPassant = GenType != quietMoves && enPassantSquareIndex != NO_SQUARE_INDEX &&
+                      (getBit(evasionMask, enPassantSquareIndex) || getBit(evasionMask, enPassantSquareIndex - PUSH));
 
-                    // Remove a bit from the current piece bitboard
-                    popBit(currentPieceBitboard, startSquareIndex);
-                }
+    U64 pawnBitboard = bitboards[PAWN];
+
+    while (pawnBitboard)
+    {
+
+        // Pop the start square index
+        int startSquareIndex = popLSB(pawnBitboard);
+
+        // Get the squares the pawn may move to if it is pinned
+        U64 pinMask = getBit(info.pinned, startSquareIndex) ? info.pinRays[startSquareIndex] : ~0ULL;
 
-                break;
+        bool fPromotion = getBit(PROMOTION_RANK, startSquareIndex);
 
-            // If the current piece is a black king
-            case blackKing:
+        // A pawn never stands on its last rank, so the square in front of it is always on the board
+        int targetSquareIndex = startSquareIndex + PUSH;
 
-                // If kingside castling is avaliable
-                if (canCastle & k)
+        // If the square in front of the pawn is empty
+        if (!getBit(occupancies[both], targetSquareIndex))
+        {
+
+            if (fPromotion)
+            {
+                // Loop over the possible promotions
+                for (int promotedPiece = KNIGHT; promotedPiece <= QUEEN; promotedPiece++)
                 {
-                    // If the squares between the king and the rook are niether occupied nor attacked
-                    if (!getBit(occupancies[both], f8) && !getBit(occupancies[both], g8) && !isSquareAttacked(e8, white) && !isSquareAttacked(f8, white))
+                    // If the promotion belongs to the generated type, add it to the move list
+                    if (getBit(((promotedPiece == QUEEN) ? queenPromotionTargets : quietTargets) & pinMask, targetSquareIndex))
                     {
-                        // Add the kingside castling to the move list
-                        output.appendMove(e8, g8, currentPiece, 0, 0, 0, 0, 1);
+                        output.appendMove(startSquareIndex, targetSquareIndex, PAWN, promotedPiece, 0, 0, 0, 0);
                     }
                 }
+            }
+            else
+            {
 
-                // If queenside castling is avaliable
-                if (canCastle & q)
+                // Add the single pawn push to the move list
+                if (getBit(quietTargets & pinMask, targetSquareIndex))
                 {
-                    // If the squares between the king and the rook are niether occupied nor attacked
-                    if (!getBit(occupancies[both], d8) && !getBit(occupancies[both], c8) && !getBit(occupancies[both], b8) && !isSquareAttacked(e8, white) && !isSquareAttacked(d8, white))
-                    {
-                        // Add the queenside casting to the move list
-                        output.appendMove(e8, c8, currentPiece, 0, 0, 0, 0, 1);
-                    }
+                    output.appendMove(startSquareIndex, targetSquareIndex, PAWN, 0, 0, 0, 0, 0);
                 }
 
-                break;
+                // Add the double pawn push to the move list
+                if (getBit(DOUBLE_PUSH_RANK, startSquareIndex) && getBit(quietTargets & pinMask, targetSquareIndex + PUSH))
+                {
+                    output.appendMove(startSquareIndex, targetSquareIndex + PUSH, PAWN, 0, 0, 1, 0, 0);
+                }
             }
         }
 
-        // Fetch the color of the knight
-        if ((sideToMove == white) ? currentPiece == whiteKnight : currentPiece == blackKnight)
+        // Get the captures of the pawn
+        U64 pawnAttacks = ATTACKS.getPawnAttacks(Color, startSquareIndex);
+        U64 captures = pawnAttacks & captureTargets & pinMask;
+
+        while (captures)
         {
 
-            // While there are bits on the current piece bitboard
-            while (currentPieceBitboard)
+            targetSquareIndex = popLSB(captures);
+
+            if (fPromotion)
             {
+                // Loop over the possible promotions
+                for (int promotedPiece = KNIGHT; promotedPiece <= QUEEN; promotedPiece++)
+                {
+                    output.appendMove(startSquareIndex, targetSquareIndex, PAWN, promotedPiece, 1, 0, 0, 0);
+                }
+            }
+            else
+            {
+                output.appendMove(startSquareIndex, targetSquareIndex, PAWN, 0, 1, 0, 0, 0);
+            }
+        }
 
-                // Get the start square index
-                startSquareIndex = getLS1BIndex(currentPieceBitboard);
+        // Add the en passant capture if the pawn attacks the en passant square and the capture leaves the king safe
+        if (fEnPassant && getBit(pawnAttacks, enPassantSquareIndex) && isEnPassantLegal(startSquareIndex, kingSquareIndex))
+        {
+            output.appendMove(startSquareIndex, enPassantSquareIndex, PAWN, 0, 1, 0, 1, 0);
+        }
+    }
 
-                // Get the attacks of the knight
-                currentPieceAttacks = ATTACKS.getKnightAttacks(startSquareIndex) & ((sideToMove == white) ? ~occupancies[white] : ~occupancies[black]);
+    generatePieceMoves<KNIGHT>(output, captureTargets | quietTargets, info);
+    generatePieceMoves<BISHOP>(output, captureTargets | quietTargets, info);
+    generatePieceMoves<ROOK>(output, captureTargets | quietTargets, info);
+    generatePieceMoves<QUEEN>(output, captureTargets | quietTargets, info);
 
-                while (currentPieceAttacks)
-                {
+    // If kingside castling is avaliable, the squares between the king and the rook are empty and the squares the king crosses are not attacked
+    if (fCastling && (canCastle & KINGSIDE) && !(occupancies[both] & KINGSIDE_EMPTY) && !(info.sideAttacks[ENEMY] & KINGSIDE_EMPTY))
+    {
+        output.appendMove(KING_START, KINGSIDE_TARGET, KING, 0, 0, 0, 0, 1);
+    }
 
-                    // Get the target square index
-                    targetSquareIndex = getLS1BIndex(currentPieceAttacks);
+    // If queenside castling is avaliable, the squares between the king and the rook are empty and the squares the king crosses are not attacked
+    if (fCastling && (canCastle & QUEENSIDE) && !(occupancies[both] & QUEENSIDE_EMPTY) && !(info.sideAttacks[ENEMY] & QUEENSIDE_SAFE))
+    {
+        output.appendMove(KING_START, QUEENSIDE_TARGET, KING, 0, 0, 0, 0, 1);
+    }
 
-                    // If the target square is not occupied
-                    if (!getBit(((sideToMove == white) ? occupancies[black] : occupancies[white]), targetSquareIndex))
-                    {
-                        // Add the standard knight move to the move list
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 0, 0, 0, 0);
-                        // If the target square index is occupied
-                    }
-                    else
-                    {
-                        // Add the standard knight capture to the move list
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 1, 0, 0, 0);
-                    }
+    generatePieceMoves<KING>(output, kingTargets, info);
+}
 
-                    // Remove the LS1B from the attacks biboard
-                    popBit(currentPieceAttacks, targetSquareIndex);
-                }
+// Generate the list of the legal moves of the given type in a position
+MoveList Board::generateMoves(int moveType)
+{
 
-                // Remove a bit from the current piece bitboard
-                popBit(currentPieceBitboard, startSquareIndex);
-            }
-        }
+    // Initialise the move list where all of the moves are added
+    MoveList output;
 
-        // Bishop moves (same approach as the knights)
-        if ((sideToMove == white) ? currentPiece == whiteBishop : currentPiece == blackBishop)
+    // Dispatch once per node to the generator specialised on the side to move and the move type, evasions being all moves
+    if (sideToMove == white)
+    {
+        switch (moveType)
         {
+        case captureMoves:
+            generate<white, captureMoves>(output);
+            break;
+        case quietMoves:
+            generate<white, quietMoves>(output);
+            break;
+        default:
+            generate<white, allMoves>(output);
+        }
+    }
+    else
+    {
+        switch (moveType)
+        {
+        case captureMoves:
+            generate<black, captureMoves>(output);
+            break;
+        case quietMoves:
+            generate<black, quietMoves>(output);
+            break;
+        default:
+            generate<black, allMoves>(output);
+        }
+    }
 
-            while (currentPieceBitboard)
-            {
-
-                startSquareIndex = getLS1BIndex(currentPieceBitboard);
-                currentPieceAttacks = ATTACKS.getBishopAttacks(startSquareIndex, occupancies[both]) & ((sideToMove == white) ? ~occupancies[white] : ~occupancies[black]);
-
-                while (currentPieceAttacks)
-                {
+    // Return the move list
+    return output;
+}
 
-                    targetSquareIndex = getLS1BIndex(currentPieceAttacks);
+/*
+Check if the move, read from the transposition table or a killer slot, is a legal move of the position encoded exactly as the generator
+encodes it. The rules of the generator are applied to the one move with the check and pin masks of the node, so a move can be tried
+before any move is generated.
+*/
+bool Board::isLegalMove(int move)
+{
 
-                    // Quiet
-                    if (!getBit(((sideToMove == white) ? occupancies[black] : occupancies[white]), targetSquareIndex))
-                    {
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 0, 0, 0, 0);
-                        // Captures
-                    }
-                    else
-                    {
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 1, 0, 0, 0);
-                    }
+    // The encoding only uses the low 24 bits
+    if (move & ~0xffffff)
+    {
+        return false;
+    }
 
-                    popBit(currentPieceAttacks, targetSquareIndex);
-                }
+    int startSquareIndex = getStartSquareIndex(move);
+    int targetSquareIndex = getTargetSquareIndex(move);
+    int piece = getPiece(move);
+    int promotedPiece = getPromotedPiece(move);
 
-                popBit(currentPieceBitboard, startSquareIndex);
-            }
-        }
+    int pawnOffset = (sideToMove == white) ? whitePawn : blackPawn;
+    int enemy = sideToMove ^ 1;
 
-        // Rook moves (same approach as the knights)
-        if ((sideToMove == white) ? currentPiece == whiteRook : currentPiece == blackRook)
-        {
+    // The piece must be one of the side to move standing on the start square, and the target must not hold a piece of the same side
+    if (piece < pawnOffset || piece > pawnOffset + king || pieceOn[startSquareIndex] != piece || getBit(occupancies[sideToMove], targetSquareIndex))
+    {
+        return false;
+    }
 
-            while (currentPieceBitboard)
-            {
+    const AttackInfo &info = getCheckAndPinMasks();
+    bool fCapture = getBit(occupancies[enemy], targetSquareIndex);
 
-                startSquareIndex = getLS1BIndex(currentPieceBitboard);
-                currentPieceAttacks = ATTACKS.getRookAttacks(startSquareIndex, occupancies[both]) & ((sideToMove == white) ? ~occupancies[white] : ~occupancies[black]);
+    // Get the squares the piece may move to if it is pinned
+    U64 pinMask = getBit(info.pinned, startSquareIndex) ? info.pinRays[startSquareIndex] : ~0ULL;
 
-                while (currentPieceAttacks)
-                {
+    if (piece == pawnOffset)
+    {
 
-                    targetSquareIndex = getLS1BIndex(currentPieceAttacks);
+        int push = (sideToMove == white) ? -8 : 8;
+        bool fLastRank = (sideToMove == white) ? (targetSquareIndex < 8) : (targetSquareIndex >= 56);
+        bool fDoublePushRank = (sideToMove == white) ? (startSquareIndex >= 48) : (startSquareIndex < 16);
+        U64 pawnAttacks = ATTACKS.getPawnAttacks(sideToMove, startSquareIndex);
 
-                    // Quiet
-                    if (!getBit(((sideToMove == white) ? occupancies[black] : occupancies[white]), targetSquareIndex))
-                    {
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 0, 0, 0, 0);
-                        // Captures
-                    }
-                    else
-                    {
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 1, 0, 0, 0);
-                    }
+        // A pawn reaching the last rank must promote to a knight, bishop, rook or queen of its side, and no other pawn move promotes
+        if (isCastling(move) || (fLastRank ? (promotedPiece < pawnOffset + knight || promotedPiece > pawnOffset + queen) : promotedPiece != 0))
+        {
+            return false;
+        }
 
-                    popBit(currentPieceAttacks, targetSquareIndex);
-                }
+        // En passant takes the pawn which just pushed two squares and must not uncover the king
+        if (isEnPassant(move))
+        {
+            return isCapture(move) && !isDoublePawnPush(move) && targetSquareIndex == enPassantSquareIndex && getBit(pawnAttacks, targetSquareIndex) &&
+                   (getBit(info.evasionMask, enPassantSquareIndex) || getBit(info.evasionMask, enPassantSquareIndex - push)) &&
+                   isEnPassantLegal(startSquareIndex, getLS1BIndex(bitboards[pawnOffset + king]));
+        }
 
-                popBit(currentPieceBitboard, startSquareIndex);
-            }
+        if (isCapture(move) != fCapture)
+        {
+            return false;
         }
 
-        // Queen moves (same approach as the knights)
-        if ((sideToMove == white) ? currentPiece == whiteQueen : currentPiece == blackQueen)
+        if (fCapture)
         {
+            return !isDoublePawnPush(move) && getBit(pawnAttacks & info.evasionMask & pinMask, targetSquareIndex);
+        }
 
-            while (currentPieceBitboard)
-            {
+        // A push needs the square in front of the pawn to be empty, and a double push the one behind the target as well
+        if (getBit(occupancies[both], startSquareIndex + push))
+        {
+            return false;
+        }
 
-                startSquareIndex = getLS1BIndex(currentPieceBitboard);
-                currentPieceAttacks = ATTACKS.getQueenAttacks(startSquareIndex, occupancies[both]) & ((sideToMove == white) ? ~occupancies[white] : ~occupancies[black]);
+        if (isDoublePawnPush(move))
+        {
+            return fDoublePushRank && targetSquareIndex == startSquareIndex + 2 * push && !getBit(occupancies[both], targetSquareIndex) &&
+                   getBit(info.evasionMask & pinMask, targetSquareIndex);
+        }
 
-                while (currentPieceAttacks)
-                {
+        return targetSquareIndex == startSquareIndex + push && getBit(info.evasionMask & pinMask, targetSquareIndex);
+    }
 
-                    targetSquareIndex = getLS1BIndex(currentPieceAttacks);
+    // Only pawns promote, push two squares and capture en passant, and the capture flag must match the target square
+    if (promotedPiece || isDoublePawnPush(move) || isEnPassant(move) || isCapture(move) != fCapture)
+    {
+        return false;
+    }
 
-                    // Quiet
-                    if (!getBit(((sideToMove == white) ? occupancies[black] : occupancies[white]), targetSquareIndex))
-                    {
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 0, 0, 0, 0);
-                        // Captures
-                    }
-                    else
-                    {
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 1, 0, 0, 0);
-                    }
+    if (isCastling(move))
+    {
 
-                    popBit(currentPieceAttacks, targetSquareIndex);
-                }
+        int kingStart = (sideToMove == white) ? e1 : e8;
+        int kingsideTarget = (sideToMove == white) ? g1 : g8, queensideTarget = (sideToMove == white) ? c1 : c8;
 
-                popBit(currentPieceBitboard, startSquareIndex);
-            }
+        // Castling is never an evasion, and the king must still stand on its start square with the right to castle
+        if (piece != pawnOffset + king || startSquareIndex != kingStart || info.evasionMask != ~0ULL)
+        {
+            return false;
         }
 
-        // King moves (same approach as the knights)
-        if ((sideToMove == white) ? currentPiece == whiteKing : currentPiece == blackKing)
+        // The squares between the king and the rook must be empty and the squares the king crosses not attacked, as in the generator
+        if (targetSquareIndex == kingsideTarget)
         {
+            U64 emptySquares = (1ULL << (kingStart + 1)) | (1ULL << (kingStart + 2));
 
-            while (currentPieceBitboard)
-            {
-
-                startSquareIndex = getLS1BIndex(currentPieceBitboard);
-                currentPieceAttacks = ATTACKS.getKingAttacks(startSquareIndex) & ((sideToMove == white) ? ~occupancies[white] : ~occupancies[black]);
-
-                while (currentPieceAttacks)
-                {
+            return (canCastle & ((sideToMove == white) ? K : k)) && !(occupancies[both] & emptySquares) && !(info.sideAttacks[enemy] & emptySquares);
+        }
 
-                    targetSquareIndex = getLS1BIndex(currentPieceAttacks);
+        if (targetSquareIndex == queensideTarget)
+        {
+            U64 emptySquares = (1ULL << (kingStart - 1)) | (1ULL << (kingStart - 2)) | (1ULL << (kingStart - 3));
+            U64 safeSquares = (1ULL << (kingStart - 1)) | (1ULL << (kingStart - 2));
 
-                    // Quiet
-                    if (!getBit(((sideToMove == white) ? occupancies[black] : occupancies[white]), targetSquareIndex))
-                    {
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 0, 0, 0, 0);
-                        // Captures
-                    }
-                    else
-                    {
-                        output.appendMove(startSquareIndex, targetSquareIndex, currentPiece, 0, 1, 0, 0, 0);
-                    }
+            return (canCastle & ((sideToMove == white) ? Q : q)) && !(occupancies[both] & emptySquares) && !(info.sideAttacks[enemy] & safeSquares);
+        }
 
-                    popBit(currentPieceAttacks, targetSquareIndex);
-                }
+        return false;
+    }
 
-                popBit(currentPieceBitboard, startSquareIndex);
-            }
-        }
+    // The king escapes a check by itself, so only its moves ignore the evasion mask, but it may never step on an attacked square
+    if (piece == pawnOffset + king)
+    {
+        return getBit(ATTACKS.getKingAttacks(startSquareIndex) & ~info.kingDanger, targetSquareIndex);
     }
 
-    // Return the move list
-    return output;
+    return getBit(ATTACKS.getPieceAttacks(piece, startSquareIndex, occupancies[both]) & info.evasionMask & pinMask, targetSquareIndex);
 }
 
 // Determine if the king is in the check
 bool Board::isKingInCheck()
 {
-    // Return true if the square, at which the king is attacked by the opposite color
-    return isSquareAttacked((sideToMove == white) ? getLS1BIndex(bitboards[whiteKing]) : getLS1BIndex(bitboards[blackKing]), sideToMove ^ 1);
+    // The checkers are shared with the move generation of the node
+    return getCheckAndPinMasks().checkers != 0ULL;
 }
 
 // Pass a turn to the opposite color
@@ -998,12 +969,9 @@ void Board::switchSideToMove()
 }
 
 // Write a hash entry into the transposition table
-void Board::writeHashEntry(int score, int depth, int searchPly, int flag)
+void Board::writeHashEntry(int score, int depth, int searchPly, int flag, int move)
 {
 
-    // Locate the transposition node and get the reference to it
-    TranspositionNode *pHashEntry = &TRANSPOSITION_TABLE[hashKey % NUM_TT_ENTRIES];
-
     // Adjust the score if the node is a checkmating one
     if (score < -CHECKMATE_BOUND)
     {
@@ -1014,26 +982,29 @@ void Board::writeHashEntry(int score, int depth, int searchPly, int flag)
         score += searchPly;
     }
 
-    // Write data into the transposition node
-    pHashEntry->hashKey = hashKey;
-    pHashEntry->score = score;
-    pHashEntry->depth = depth;
-    pHashEntry->flag = flag;
+    // Write data into the transposition table
+    TRANSPOSITION_TABLE.store(hashKey, move, score, depth, flag);
 }
 
 // Read the hash entry from the transposition table
-int Board::readHashEntry(int alpha, int beta, int depth, int searchPly)
+int Board::readHashEntry(int alpha, int beta, int depth, int searchPly, bool &fHit, int &hashMove)
 {
 
-    // Locate the transposition node and get the reference to it
-    TranspositionNode *pHashEntry = &TRANSPOSITION_TABLE[hashKey % NUM_TT_ENTRIES];
+    U64 hashData;
+
+    // Look the position up in the transposition table
+    fHit = TRANSPOSITION_TABLE.probe(hashKey, hashData);
+
+    // The best move is useful for the move ordering even if the score cannot be used
+    hashMove = fHit ? getHashMove(hashData) : 0;
 
     // Check if the value stored in the transposition table can be used
-    if (pHashEntry->hashKey == hashKey && pHashEntry->depth >= depth && searchPly)
+    if (fHit && getHashDepth(hashData) >= depth && searchPly)
     {
 
         // Get the score
-        int score = pHashEntry->score;
+        int score = getHashScore(hashData);
+        int flag = getHashFlag(hashData);
 
         // Adjust the score if the node is a checkmating one
         if (score < -CHECKMATE_BOUND)
@@ -1046,19 +1017,19 @@ int Board::readHashEntry(int alpha, int beta, int depth, int searchPly)
         }
 
         // Retrieve the value based on the flags provided
-        if (pHashEntry->flag == fPV_HASH)
+        if (flag == fPV_HASH)
         {
             return score;
         }
 
         // Retrieve the value based on the flags provided
-        if (pHashEntry->flag == fALPHA_HASH && score <= alpha)
+        if (flag == fALPHA_HASH && score <= alpha)
         {
             return alpha;
         }
 
         // Retrieve the value based on the flags provided
-        if (pHashEntry->flag == fBETA_HASH && score >= beta)
+        if (flag == fBETA_HASH && score >= beta)
         {
             return beta;
         }
@@ -1068,58 +1039,148 @@ int Board::readHashEntry(int alpha, int beta, int depth, int searchPly)
     return fHASH_NOT_FOUND;
 }
 
-int Board::makeMove(int move)
+// Evaluate the position with the neural network if one is set and with the hand-crafted evaluation otherwise
+int Board::evaluate()
+{
+    return pNetwork ? pNetwork->evaluate(accumulator, sideToMove) : staticEvaluate();
+}
+
+// Look the static evaluation up in the evaluation cache, evaluating and storing it on a miss
+int Board::readEvaluation(bool &fHit)
+{
+    int score;
+
+    fHit = EVALUATION_CACHE.probe(hashKey, score);
+
+    if (!fHit)
+    {
+        score = evaluate();
+        EVALUATION_CACHE.store(hashKey, score);
+    }
+
+    return score;
+}
+
+// Apply the pieces added and removed by the move to the network accumulator, or take them back when unmaking it
+void Board::updateAccumulator(int move, int capturedPiece, bool fUnmake)
 {
+    int piece = getPiece(move);
+    int startSquareIndex = getStartSquareIndex(move);
+    int targetSquareIndex = getTargetSquareIndex(move);
+    int promotedPiece = getPromotedPiece(move);
+
+    // Features given as piece * 64 + square index, a move adds at most two and removes at most two
+    int addedFeatures[2], removedFeatures[2];
+    int numAdded = 0, numRemoved = 0;
+
+    removedFeatures[numRemoved++] = piece * 64 + startSquareIndex;
+    addedFeatures[numAdded++] = (promotedPiece ? promotedPiece : piece) * 64 + targetSquareIndex;
+
+    if (capturedPiece != NO_PIECE)
+    {
+        int capturedSquareIndex = isEnPassant(move) ? targetSquareIndex + ((piece == whitePawn) ? 8 : -8) : targetSquareIndex;
+        removedFeatures[numRemoved++] = capturedPiece * 64 + capturedSquareIndex;
+    }
+
+    if (isCastling(move))
+    {
+        switch (targetSquareIndex)
+        {
+
+        case (g1):
+            removedFeatures[numRemoved++] = whiteRook * 64 + h1;
+            addedFeatures[numAdded++] = whiteRook * 64 + f1;
+            break;
+
+        case (c1):
+            removedFeatures[numRemoved++] = whiteRook * 64 + a1;
+            addedFeatures[numAdded++] = whiteRook * 64 + d1;
+            break;
 
-    U64 tempBitboards[12], tempOccupancies[3];
-    U64 tempHash = hashKey;
-    int tempEnPassantSquareIndex = enPassantSquareIndex, tempCanCastle = canCastle;
+        case (g8):
+            removedFeatures[numRemoved++] = blackRook * 64 + h8;
+            addedFeatures[numAdded++] = blackRook * 64 + f8;
+            break;
+
+        case (c8):
+            removedFeatures[numRemoved++] = blackRook * 64 + a8;
+            addedFeatures[numAdded++] = blackRook * 64 + d8;
+            break;
+        }
+    }
+
+    // Unmaking the move adds back what making it removed
+    if (fUnmake)
+    {
+        pNetwork->updateAccumulator(accumulator, removedFeatures, numRemoved, addedFeatures, numAdded);
+    }
+    else
+    {
+        pNetwork->updateAccumulator(accumulator, addedFeatures, numAdded, removedFeatures, numRemoved);
+    }
+}
 
-    memcpy(tempBitboards, bitboards, sizeof(tempBitboards));
-    memcpy(tempOccupancies, occupancies, sizeof(tempOccupancies));
+// Make a legal move, switching the side to move and saving what unmakeMove needs into the undo record
+void Board::makeMove(int move, UndoInfo &undo)
+{
 
     int piece = getPiece(move);
     int startSquareIndex = getStartSquareIndex(move);
     int targetSquareIndex = getTargetSquareIndex(move);
     int promotedPiece = getPromotedPiece(move);
 
+    undo.hashKey = hashKey;
+    undo.pawnKey = pawnKey;
+    undo.capturedPiece = NO_PIECE;
+
+    // The child position gets the next attack info slot, leaving the attack info of this position for after the unmake
+    attackInfoPly++;
+    undo.enPassantSquareIndex = enPassantSquareIndex;
+    undo.canCastle = canCastle;
+    undo.pieceSquareScore[opening] = pieceSquareScore[opening];
+    undo.pieceSquareScore[endgame] = pieceSquareScore[endgame];
+    undo.gameScore = gameScore;
+
     popBit(bitboards[piece], startSquareIndex);
     setBit(bitboards[piece], targetSquareIndex);
+    occupancies[sideToMove] ^= (1ULL << startSquareIndex) | (1ULL << targetSquareIndex);
+    removePieceScore(piece, startSquareIndex);
+    addPieceScore(piece, targetSquareIndex);
 
     hashKey ^= PIECE_KEYS[piece][startSquareIndex];
     hashKey ^= PIECE_KEYS[piece][targetSquareIndex];
 
-    if (isCapture(move))
+    if (piece == whitePawn || piece == blackPawn)
     {
+        pawnKey ^= PIECE_KEYS[piece][startSquareIndex] ^ PIECE_KEYS[piece][targetSquareIndex];
+    }
 
-        int startPiece = 0, endPiece = 0;
+    if (isCapture(move))
+    {
 
-        if (sideToMove == white)
-        {
+        // An en passant capture takes the pawn behind the target square
+        int capturedSquareIndex = isEnPassant(move) ? targetSquareIndex + ((sideToMove == white) ? 8 : -8) : targetSquareIndex;
 
-            startPiece = blackPawn;
-            endPiece = blackKing;
-        }
-        else if (sideToMove == black)
-        {
+        // The mailbox still holds the captured piece, as the moved piece only enters it below
+        int capturedPiece = pieceOn[capturedSquareIndex];
 
-            startPiece = whitePawn;
-            endPiece = whiteKing;
-        }
+        popBit(bitboards[capturedPiece], capturedSquareIndex);
+        occupancies[sideToMove ^ 1] ^= 1ULL << capturedSquareIndex;
+        removePieceScore(capturedPiece, capturedSquareIndex);
+        hashKey ^= PIECE_KEYS[capturedPiece][capturedSquareIndex];
+        pieceOn[capturedSquareIndex] = NO_PIECE;
 
-        for (int currentPiece = startPiece; currentPiece <= endPiece; currentPiece++)
+        if (capturedPiece == whitePawn || capturedPiece == blackPawn)
         {
-
-            if (getBit(bitboards[currentPiece], targetSquareIndex))
-            {
-
-                popBit(bitboards[currentPiece], targetSquareIndex);
-                hashKey ^= PIECE_KEYS[currentPiece][targetSquareIndex];
-                break;
-            }
+            pawnKey ^= PIECE_KEYS[capturedPiece][capturedSquareIndex];
         }
+
+        undo.capturedPiece = capturedPiece;
     }
 
+    pieceOn[startSquareIndex] = NO_PIECE;
+    pieceOn[targetSquareIndex] = promotedPiece ? promotedPiece : piece;
+
     if (promotedPiece)
     {
 
@@ -1127,36 +1188,24 @@ int Board::makeMove(int move)
         {
 
             popBit(bitboards[whitePawn], targetSquareIndex);
+            removePieceScore(whitePawn, targetSquareIndex);
             hashKey ^= PIECE_KEYS[whitePawn][targetSquareIndex];
+            pawnKey ^= PIECE_KEYS[whitePawn][targetSquareIndex];
         }
         else if (sideToMove == black)
         {
 
             popBit(bitboards[blackPawn], targetSquareIndex);
+            removePieceScore(blackPawn, targetSquareIndex);
             hashKey ^= PIECE_KEYS[blackPawn][targetSquareIndex];
+            pawnKey ^= PIECE_KEYS[blackPawn][targetSquareIndex];
         }
 
         setBit(bitboards[promotedPiece], targetSquareIndex);
+        addPieceScore(promotedPiece, targetSquareIndex);
         hashKey ^= PIECE_KEYS[promotedPiece][targetSquareIndex];
     }
 
-    if (isEnPassant(move))
-    {
-
-        if (sideToMove == white)
-        {
-
-            popBit(bitboards[blackPawn], targetSquareIndex + 8);
-            hashKey ^= PIECE_KEYS[blackPawn][targetSquareIndex + 8];
-        }
-        else if (sideToMove == black)
-        {
-
-            popBit(bitboards[whitePawn], targetSquareIndex - 8);
-            hashKey ^= PIECE_KEYS[whitePawn][targetSquareIndex - 8];
-        }
-    }
-
     if (enPassantSquareIndex != NO_SQUARE_INDEX)
     {
         hashKey ^= ENPASSANT_KEYS[enPassantSquareIndex];
@@ -1189,6 +1238,11 @@ int Board::makeMove(int move)
 
             popBit(bitboards[whiteRook], h1);
             setBit(bitboards[whiteRook], f1);
+            pieceOn[h1] = NO_PIECE;
+            pieceOn[f1] = whiteRook;
+            occupancies[white] ^= (1ULL << h1) | (1ULL << f1);
+            removePieceScore(whiteRook, h1);
+            addPieceScore(whiteRook, f1);
 
             hashKey ^= PIECE_KEYS[whiteRook][h1];
             hashKey ^= PIECE_KEYS[whiteRook][f1];
@@ -1199,6 +1253,11 @@ int Board::makeMove(int move)
 
             popBit(bitboards[whiteRook], a1);
             setBit(bitboards[whiteRook], d1);
+            pieceOn[a1] = NO_PIECE;
+            pieceOn[d1] = whiteRook;
+            occupancies[white] ^= (1ULL << a1) | (1ULL << d1);
+            removePieceScore(whiteRook, a1);
+            addPieceScore(whiteRook, d1);
 
             hashKey ^= PIECE_KEYS[whiteRook][a1];
             hashKey ^= PIECE_KEYS[whiteRook][d1];
@@ -1209,6 +1268,11 @@ int Board::makeMove(int move)
 
             popBit(bitboards[blackRook], h8);
             setBit(bitboards[blackRook], f8);
+            pieceOn[h8] = NO_PIECE;
+            pieceOn[f8] = blackRook;
+            occupancies[black] ^= (1ULL << h8) | (1ULL << f8);
+            removePieceScore(blackRook, h8);
+            addPieceScore(blackRook, f8);
 
             hashKey ^= PIECE_KEYS[blackRook][h8];
             hashKey ^= PIECE_KEYS[blackRook][f8];
@@ -1219,6 +1283,11 @@ int Board::makeMove(int move)
 
             popBit(bitboards[blackRook], a8);
             setBit(bitboards[blackRook], d8);
+            pieceOn[a8] = NO_PIECE;
+            pieceOn[d8] = blackRook;
+            occupancies[black] ^= (1ULL << a8) | (1ULL << d8);
+            removePieceScore(blackRook, a8);
+            addPieceScore(blackRook, d8);
 
             hashKey ^= PIECE_KEYS[blackRook][a8];
             hashKey ^= PIECE_KEYS[blackRook][d8];
@@ -1234,24 +1303,142 @@ int Board::makeMove(int move)
 
     hashKey ^= CASTLING_KEYS[canCastle];
 
-    resetOccupancies();
-    populateOccupancies();
+    // The child key is known now, so its bucket loads while the child node is being set up
+    TRANSPOSITION_TABLE.prefetch(hashKey ^ SIDE_KEY);
+
+    occupancies[both] = occupancies[white] | occupancies[black];
+
+    if (pNetwork)
+    {
+        updateAccumulator(move, undo.capturedPiece, false);
+    }
+
+#ifdef DEBUG_BUILD
+    verifyOccupancies();
+    verifyEvaluationAccumulators();
+#endif
+
+    switchSideToMove();
+    hashKey ^= SIDE_KEY;
+}
+
+// Take back the move, restoring the position saved in the undo record by makeMove
+void Board::unmakeMove(int move, const UndoInfo &undo)
+{
+
+    switchSideToMove();
+    attackInfoPly--;
+
+    int piece = getPiece(move);
+    int startSquareIndex = getStartSquareIndex(move);
+    int targetSquareIndex = getTargetSquareIndex(move);
+
+    // Lift the moved piece, or the piece it promoted to, off the target square and put the piece back on the start square
+    popBit(bitboards[pieceOn[targetSquareIndex]], targetSquareIndex);
+    setBit(bitboards[piece], startSquareIndex);
+    occupancies[sideToMove] ^= (1ULL << startSquareIndex) | (1ULL << targetSquareIndex);
+    pieceOn[targetSquareIndex] = NO_PIECE;
+    pieceOn[startSquareIndex] = piece;
+
+    if (undo.capturedPiece != NO_PIECE)
+    {
+        int capturedSquareIndex = isEnPassant(move) ? targetSquareIndex + ((sideToMove == white) ? 8 : -8) : targetSquareIndex;
+
+        setBit(bitboards[undo.capturedPiece], capturedSquareIndex);
+        occupancies[sideToMove ^ 1] ^= 1ULL << capturedSquareIndex;
+        pieceOn[capturedSquareIndex] = undo.capturedPiece;
+    }
+
+    if (isCastling(move))
+    {
+
+        switch (targetSquareIndex)
+        {
+
+        case (g1):
+            popBit(bitboards[whiteRook], f1);
+            setBit(bitboards[whiteRook], h1);
+            pieceOn[f1] = NO_PIECE;
+            pieceOn[h1] = whiteRook;
+            occupancies[white] ^= (1ULL << h1) | (1ULL << f1);
+            break;
+
+        case (c1):
+            popBit(bitboards[whiteRook], d1);
+            setBit(bitboards[whiteRook], a1);
+            pieceOn[d1] = NO_PIECE;
+            pieceOn[a1] = whiteRook;
+            occupancies[white] ^= (1ULL << a1) | (1ULL << d1);
+            break;
+
+        case (g8):
+            popBit(bitboards[blackRook], f8);
+            setBit(bitboards[blackRook], h8);
+            pieceOn[f8] = NO_PIECE;
+            pieceOn[h8] = blackRook;
+            occupancies[black] ^= (1ULL << h8) | (1ULL << f8);
+            break;
+
+        case (c8):
+            popBit(bitboards[blackRook], d8);
+            setBit(bitboards[blackRook], a8);
+            pieceOn[d8] = NO_PIECE;
+            pieceOn[a8] = blackRook;
+            occupancies[black] ^= (1ULL << a8) | (1ULL << d8);
+            break;
+        }
+    }
+
+    hashKey = undo.hashKey;
+    pawnKey = undo.pawnKey;
+    enPassantSquareIndex = undo.enPassantSquareIndex;
+    canCastle = undo.canCastle;
+    pieceSquareScore[opening] = undo.pieceSquareScore[opening];
+    pieceSquareScore[endgame] = undo.pieceSquareScore[endgame];
+    gameScore = undo.gameScore;
+
+    occupancies[both] = occupancies[white] | occupancies[black];
 
-    if (isKingInCheck())
+    if (pNetwork)
     {
+        updateAccumulator(move, undo.capturedPiece, true);
+    }
+
+#ifdef DEBUG_BUILD
+    verifyOccupancies();
+    verifyEvaluationAccumulators();
+#endif
+}
 
-        memcpy(bitboards, tempBitboards, sizeof(tempBitboards));
-        memcpy(occupancies, tempOccupancies, sizeof(tempOccupancies));
-        enPassantSquareIndex = tempEnPassantSquareIndex;
-        canCastle = tempCanCastle;
-        hashKey = tempHash;
-        return 0;
+// Pass the turn without moving, saving the en passant square and the hash key into the undo record
+void Board::makeNullMove(UndoInfo &undo)
+{
+
+    undo.hashKey = hashKey;
+    undo.enPassantSquareIndex = enPassantSquareIndex;
+
+    attackInfoPly++;
+
+    if (enPassantSquareIndex != NO_SQUARE_INDEX)
+    {
+        hashKey ^= ENPASSANT_KEYS[enPassantSquareIndex];
     }
 
+    enPassantSquareIndex = NO_SQUARE_INDEX;
+
     switchSideToMove();
     hashKey ^= SIDE_KEY;
+}
+
+// Take back the null move
+void Board::unmakeNullMove(const UndoInfo &undo)
+{
 
-    return 1;
+    switchSideToMove();
+    attackInfoPly--;
+
+    hashKey = undo.hashKey;
+    enPassantSquareIndex = undo.enPassantSquareIndex;
 }
 
 // Load the board from the FEN string
@@ -1262,9 +1449,10 @@ void Board::loadFenString(const string &fenString)
     resetBitboards();
     resetOccupancies();
 
-    // Initialise the square index and the en passant square
+    // Initialise the square index and reset the state variables
     int squareIndex = 0;
     enPassantSquareIndex = NO_SQUARE_INDEX;
+    canCastle = 0;
 
     // Loop through the characters in the FEN string
     for (int index = 0; index < (int)fenString.length(); index++)
@@ -1280,8 +1468,9 @@ void Board::loadFenString(const string &fenString)
             if (squareIndex < 64)
             {
 
-                // Set the bit corresponding bitboard
+                // Set the bit corresponding bitboard and enter the piece into the mailbox
                 setBit(bitboards[PIECE_INDEX_TO_ASCII.find(symbol)], squareIndex);
+                pieceOn[squareIndex] = PIECE_INDEX_TO_ASCII.find(symbol);
                 squareIndex++;
 
                 // Parse other data (castling, en passant etc.)
@@ -1289,6 +1478,19 @@ void Board::loadFenString(const string &fenString)
             else
             {
 
+                // If an en passant square is available
+                if (fenString[index - 1] == ' ' && isdigit(fenString[index + 1]))
+                {
+
+                    // Get the file and rank of the en passant square
+                    int file = symbol - 'a';
+                    int rank = 8 - (fenString[index + 1] - '0');
+                    enPassantSquareIndex = rank * 8 + file;
+
+                    // The file letter of the square is not a side to move
+                    continue;
+                }
+
                 switch (symbol)
                 {
                 // Get the side to move
@@ -1313,16 +1515,6 @@ void Board::loadFenString(const string &fenString)
                     canCastle |= q;
                     break;
                 }
-
-                // If an en passant square is available
-                if (fenString[index - 1] == ' ' && isdigit(fenString[index + 1]))
-                {
-
-                    // Get the file and rank of the en passant square
-                    int file = symbol - 'a';
-                    int rank = 8 - (fenString[index + 1] - '0');
-                    enPassantSquareIndex = rank * 8 + file;
-                }
             }
 
             // If the character is a digit, it represents empty squares
@@ -1333,19 +1525,26 @@ void Board::loadFenString(const string &fenString)
         }
     }
 
-    // Calculate the occupancies based on the updated bitboards
+    // Calculate the occupancies and the evaluation accumulators based on the updated bitboards
     populateOccupancies();
+    calculatePieceSquareScore(pieceSquareScore);
+    gameScore = calculateGameScore();
+
+    if (pNetwork)
+    {
+        pNetwork->refreshAccumulator(accumulator, bitboards);
+    }
 }
 
 // Load a move string in FEN notation
-void Board::loadMoveString(const string &moveString)
+bool Board::loadMoveString(const string &moveString)
 {
 
     // Get the start square index and the target square index from a move
     int startSquareIndex = (moveString[0] - 'a') + (8 - (moveString[1] - '0')) * 8;
     int targetSquareIndex = (moveString[2] - 'a') + (8 - (moveString[3] - '0')) * 8;
 
-    // Generate all pseudo-legal moves in a position
+    // Generate the legal moves of the position, so a matching move never leaves the king in check
     MoveList moves = generateMoves();
 
     // Loop over the moves
@@ -1361,7 +1560,7 @@ void Board::loadMoveString(const string &moveString)
             // Discard the moves trying to avoid pawn promotion
             if ((moveString[3] == '8' && moveString[4] == 'P') || (moveString[3] == '1' && moveString[4] == 'p'))
             {
-                return;
+                return false;
             }
 
             // Discard moves trying to promote to early
@@ -1369,21 +1568,21 @@ void Board::loadMoveString(const string &moveString)
             {
                 if ((PIECE_INDEX_TO_ASCII[getPromotedPiece(move)] != moveString[4]) || (PIECE_INDEX_TO_ASCII[getPromotedPiece(move) - 6] != moveString[4]))
                 {
-                    return;
+                    return false;
                 }
             }
 
-            // Update the repetition table
-            repetitions[repetitionIndex] = hashKey;
-            repetitionIndex++;
-
-            // Commit the move
-            makeMove(move);
+            // Commit the move, which is never taken back
+            UndoInfo undo;
+            makeMove(move, undo);
+            return true;
         }
     }
+
+    return false;
 }
 
-// Calculate the game score
+// Calculate the game score from scratch
 int Board::calculateGameScore()
 {
 
@@ -1411,17 +1610,6 @@ int Board::calculateGameScore()
     return whiteScore - blackScore;
 }
 
-// Reset the en passant square index
-void Board::resetEnPassantSquareIndex()
-{
-    enPassantSquareIndex = NO_SQUARE_INDEX;
-}
-
-void Board::updateHashKey(int value)
-{
-    hashKey ^= value;
-}
-
 // Get the current side to move
 int Board::getSideToMove()
 {
@@ -1435,14 +1623,46 @@ int Board::getEnPassantSquareIndex()
 }
 
 // Get the hash key
-int Board::getHashKey()
+U64 Board::getHashKey()
 {
     return hashKey;
 }
 
+U64 Board::getPawnKey()
+{
+    return pawnKey;
+}
+
+// Cache the pawn structure evaluation in the given table, or evaluate it from scratch if it is null
+void Board::setPawnHashTable(PawnHashTable *pTable)
+{
+    pPawnTable = pTable;
+}
+
+// Evaluate with the given neural network, or with the hand-crafted evaluation if it is null, refreshing the accumulator
+void Board::setNetwork(const NeuralNetwork *pNetwork)
+{
+    this->pNetwork = pNetwork;
+
+    if (pNetwork)
+    {
+        pNetwork->refreshAccumulator(accumulator, bitboards);
+    }
+}
+
+// Forget the attack info of the position, so the next query computes it again
+void Board::clearAttackInfo()
+{
+    AttackInfo &info = getAttackInfoSlot();
+
+    info.attacksKey[white] = 0ULL;
+    info.attacksKey[black] = 0ULL;
+    info.checksKey = 0ULL;
+}
+
 // Get the array of bitboards
 U64 *Board::getBitboards()
 {
     return bitboards;
 }
-;
\ No newline at end of file
+;
@@ -0,0 +1,52 @@
+#include "EvaluationCache.h"
+
+// Reallocate the cache with the given size in megabytes, which also empties it
+void EvaluationCache::resize(int megabytes)
+{
+    // At least one megabyte is always allocated
+    size_t size = (size_t)((megabytes < 1) ? 1 : megabytes) * 1024 * 1024;
+
+    // A freshly constructed vector value-initialises the atomics, so every entry starts out empty
+    entries = std::vector<std::atomic<U64>>(size / sizeof(std::atomic<U64>));
+}
+
+// Remove all of the entries
+void EvaluationCache::clear()
+{
+    // Allocate the default cache if none has been requested yet
+    if (entries.empty())
+    {
+        resize(DEFAULT_EVAL_CACHE_MEGABYTES);
+        return;
+    }
+
+    for (std::atomic<U64> &entry : entries)
+    {
+        entry.store(0ULL, std::memory_order_relaxed);
+    }
+}
+
+// Allocate the default cache if none has been requested yet
+void EvaluationCache::prepare()
+{
+    if (entries.empty())
+    {
+        resize(DEFAULT_EVAL_CACHE_MEGABYTES);
+    }
+}
+
+// Empty the cache if its entries were computed by another evaluator than the one of the given generation
+void EvaluationCache::setEvaluator(U64 generation)
+{
+    if (generation != evaluatorGeneration)
+    {
+        clear();
+        evaluatorGeneration = generation;
+    }
+}
+
+// Get the size of the cache in megabytes
+int EvaluationCache::getMegabytes() const
+{
+    return (int)(entries.size() * sizeof(std::atomic<U64>) / (1024 * 1024));
+}
@@ -0,0 +1,391 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <cmath>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+#include "NeuralNetwork.h"
+#include "globals.h"
+#include "bitboard_operations.h"
+#include "engine_exceptions.h"
+#include "enum.h"
+
+
+// Identifies the network file format and its version
+static const char NETWORK_MAGIC[8] = {'P', 'E', 'A', 'C', 'H', 'N', 'N', '1'};
+
+// Sizes of the parts of the network file, the weights start on a cache line after the header
+static const size_t NETWORK_HEADER_SIZE = 64;
+static const size_t NETWORK_WEIGHTS_SIZE = (NNUE_INPUTS * NNUE_HIDDEN + NNUE_HIDDEN + 2 * NNUE_HIDDEN) * sizeof(int16_t) + sizeof(int32_t);
+static const size_t NETWORK_FILE_SIZE = NETWORK_HEADER_SIZE + ((NETWORK_WEIGHTS_SIZE + 63) & ~(size_t)63);
+
+// Most features a position can have, one per square, as a FEN may place more than the 32 pieces of a legal game
+static const int MAX_FEATURES = 64;
+
+// Number of network files loaded so far, which numbers the generations of the weights
+static U64 numNetworkLoads = 0ULL;
+
+// The widest integer vectors the target offers, the scalar loops below are used without any
+#if defined(__AVX2__)
+
+#define NNUE_SIMD
+typedef __m256i Vector;
+const int VECTOR_LANES = 16;
+
+static inline Vector loadVector(const int16_t *pValues) { return _mm256_loadu_si256((const __m256i *)pValues); }
+static inline void storeVector(int16_t *pValues, Vector values) { _mm256_storeu_si256((__m256i *)pValues, values); }
+static inline Vector addVectors(Vector a, Vector b) { return _mm256_add_epi16(a, b); }
+static inline Vector subtractVectors(Vector a, Vector b) { return _mm256_sub_epi16(a, b); }
+static inline Vector clipVector(Vector values) { return _mm256_min_epi16(_mm256_max_epi16(values, _mm256_setzero_si256()), _mm256_set1_epi16(NNUE_QA)); }
+static inline Vector multiplyAddVectors(Vector sums, Vector a, Vector b) { return _mm256_add_epi32(sums, _mm256_madd_epi16(a, b)); }
+static inline Vector zeroVector() { return _mm256_setzero_si256(); }
+
+static inline int sumVector(Vector sums)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    return _mm_cvtsi128_si32(sum);
+}
+
+#elif defined(__SSE4_1__)
+
+#define NNUE_SIMD
+typedef __m128i Vector;
+const int VECTOR_LANES = 8;
+
+static inline Vector loadVector(const int16_t *pValues) { return _mm_loadu_si128((const __m128i *)pValues); }
+static inline void storeVector(int16_t *pValues, Vector values) { _mm_storeu_si128((__m128i *)pValues, values); }
+static inline Vector addVectors(Vector a, Vector b) { return _mm_add_epi16(a, b); }
+static inline Vector subtractVectors(Vector a, Vector b) { return _mm_sub_epi16(a, b); }
+static inline Vector clipVector(Vector values) { return _mm_min_epi16(_mm_max_epi16(values, _mm_setzero_si128()), _mm_set1_epi16(NNUE_QA)); }
+static inline Vector multiplyAddVectors(Vector sums, Vector a, Vector b) { return _mm_add_epi32(sums, _mm_madd_epi16(a, b)); }
+static inline Vector zeroVector() { return _mm_setzero_si128(); }
+
+static inline int sumVector(Vector sums)
+{
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0x4e));
+    sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, 0xb1));
+    return _mm_cvtsi128_si32(sums);
+}
+
+#elif defined(__wasm_simd128__)
+
+#define NNUE_SIMD
+typedef v128_t Vector;
+const int VECTOR_LANES = 8;
+
+static inline Vector loadVector(const int16_t *pValues) { return wasm_v128_load(pValues); }
+static inline void storeVector(int16_t *pValues, Vector values) { wasm_v128_store(pValues, values); }
+static inline Vector addVectors(Vector a, Vector b) { return wasm_i16x8_add(a, b); }
+static inline Vector subtractVectors(Vector a, Vector b) { return wasm_i16x8_sub(a, b); }
+static inline Vector clipVector(Vector values) { return wasm_i16x8_min(wasm_i16x8_max(values, wasm_i16x8_splat(0)), wasm_i16x8_splat(NNUE_QA)); }
+static inline Vector multiplyAddVectors(Vector sums, Vector a, Vector b) { return wasm_i32x4_add(sums, wasm_i32x4_dot_i16x8(a, b)); }
+static inline Vector zeroVector() { return wasm_i32x4_splat(0); }
+
+static inline int sumVector(Vector sums)
+{
+    return wasm_i32x4_extract_lane(sums, 0) + wasm_i32x4_extract_lane(sums, 1) + wasm_i32x4_extract_lane(sums, 2) + wasm_i32x4_extract_lane(sums, 3);
+}
+
+#endif
+
+NeuralNetwork::~NeuralNetwork()
+{
+    release();
+}
+
+// Release the mapping of the network file
+void NeuralNetwork::release()
+{
+#ifdef __linux__
+    if (pMapping)
+    {
+        munmap(pMapping, mappingSize);
+    }
+#endif
+
+    pMapping = nullptr;
+    mappingSize = 0;
+    fileContents.clear();
+    fileContents.shrink_to_fit();
+
+    featureWeights = featureBiases = outputWeights = nullptr;
+    outputBias = 0;
+}
+
+// Map the weights of the network file into memory
+void NeuralNetwork::load(const std::string &path)
+{
+    release();
+
+    // Even a failed load replaces the weights, so it starts a new generation
+    generation = ++numNetworkLoads;
+
+    const char *pData = nullptr;
+    size_t size = 0;
+
+#ifdef __linux__
+
+    // Map the file read-only, so every search thread and every process loading the same network share its pages
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    struct stat fileStatus;
+
+    if (fileDescriptor >= 0 && fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+    {
+        void *pMemory = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        if (pMemory != MAP_FAILED)
+        {
+            pMapping = pMemory;
+            mappingSize = fileStatus.st_size;
+            pData = static_cast<const char *>(pMemory);
+            size = mappingSize;
+        }
+    }
+
+    if (fileDescriptor >= 0)
+    {
+        close(fileDescriptor);
+    }
+
+#endif
+
+    // Read the file into memory where it cannot be mapped
+    if (!pData)
+    {
+        std::ifstream file(path, std::ios::binary);
+        fileContents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        pData = fileContents.data();
+        size = fileContents.size();
+    }
+
+    int32_t numInputs = 0, numHidden = 0;
+
+    if (size == NETWORK_FILE_SIZE)
+    {
+        std::memcpy(&numInputs, pData + sizeof(NETWORK_MAGIC), sizeof(int32_t));
+        std::memcpy(&numHidden, pData + sizeof(NETWORK_MAGIC) + sizeof(int32_t), sizeof(int32_t));
+    }
+
+    // Refuse files of another format or of another architecture
+    if (size != NETWORK_FILE_SIZE || std::memcmp(pData, NETWORK_MAGIC, sizeof(NETWORK_MAGIC)) != 0 || numInputs != NNUE_INPUTS || numHidden != NNUE_HIDDEN)
+    {
+        release();
+        throw CannotLoadNetworkException();
+    }
+
+    featureWeights = reinterpret_cast<const int16_t *>(pData + NETWORK_HEADER_SIZE);
+    featureBiases = featureWeights + NNUE_INPUTS * NNUE_HIDDEN;
+    outputWeights = featureBiases + NNUE_HIDDEN;
+    std::memcpy(&outputBias, outputWeights + 2 * NNUE_HIDDEN, sizeof(int32_t));
+}
+
+bool NeuralNetwork::isLoaded() const
+{
+    return featureWeights != nullptr;
+}
+
+// Get the number of the load that filled the weights, never zero once a file has been loaded
+U64 NeuralNetwork::getGeneration() const
+{
+    return generation;
+}
+
+// Fill the accumulator from scratch with the features of the piece bitboards
+void NeuralNetwork::refreshAccumulator(NNUEAccumulator &accumulator, const U64 *bitboards) const
+{
+    int features[MAX_FEATURES];
+    int numFeatures = 0;
+
+    for (int currentPiece = whitePawn; currentPiece <= blackKing; currentPiece++)
+    {
+        U64 currentPieceBitboard = bitboards[currentPiece];
+
+        while (currentPieceBitboard)
+        {
+            int squareIndex = popLSB(currentPieceBitboard);
+            features[numFeatures++] = currentPiece * 64 + squareIndex;
+        }
+    }
+
+    std::memcpy(accumulator.values[white], featureBiases, sizeof(accumulator.values[white]));
+    std::memcpy(accumulator.values[black], featureBiases, sizeof(accumulator.values[black]));
+
+    updateAccumulator(accumulator, features, numFeatures, nullptr, 0);
+}
+
+// Add and remove the piece-square features of both perspectives in a single pass over the accumulator
+void NeuralNetwork::updateAccumulator(NNUEAccumulator &accumulator, const int *addedFeatures, int numAdded, const int *removedFeatures, int numRemoved) const
+{
+    // Weight rows of the features
+    const int16_t *addedRows[MAX_FEATURES];
+    const int16_t *removedRows[MAX_FEATURES];
+
+    for (int perspective = white; perspective <= black; perspective++)
+    {
+        int16_t *pValues = accumulator.values[perspective];
+
+        for (int featureIndex = 0; featureIndex < numAdded; featureIndex++)
+        {
+            addedRows[featureIndex] = featureWeights + getFeatureIndex(perspective, addedFeatures[featureIndex] / 64, addedFeatures[featureIndex] % 64) * NNUE_HIDDEN;
+        }
+
+        for (int featureIndex = 0; featureIndex < numRemoved; featureIndex++)
+        {
+            removedRows[featureIndex] = featureWeights + getFeatureIndex(perspective, removedFeatures[featureIndex] / 64, removedFeatures[featureIndex] % 64) * NNUE_HIDDEN;
+        }
+
+#ifdef NNUE_SIMD
+        // Every chunk of the accumulator is loaded and stored once however many rows change it
+        for (int neuron = 0; neuron < NNUE_HIDDEN; neuron += VECTOR_LANES)
+        {
+            Vector values = loadVector(pValues + neuron);
+
+            for (int rowIndex = 0; rowIndex < numAdded; rowIndex++)
+            {
+                values = addVectors(values, loadVector(addedRows[rowIndex] + neuron));
+            }
+
+            for (int rowIndex = 0; rowIndex < numRemoved; rowIndex++)
+            {
+                values = subtractVectors(values, loadVector(removedRows[rowIndex] + neuron));
+            }
+
+            storeVector(pValues + neuron, values);
+        }
+#else
+        // Walking each row from start to end lets the compiler vectorise the loops with whatever the target offers
+        for (int rowIndex = 0; rowIndex < numAdded; rowIndex++)
+        {
+            for (int neuron = 0; neuron < NNUE_HIDDEN; neuron++)
+            {
+                pValues[neuron] += addedRows[rowIndex][neuron];
+            }
+        }
+
+        for (int rowIndex = 0; rowIndex < numRemoved; rowIndex++)
+        {
+            for (int neuron = 0; neuron < NNUE_HIDDEN; neuron++)
+            {
+                pValues[neuron] -= removedRows[rowIndex][neuron];
+            }
+        }
+#endif
+    }
+}
+
+// Run the output layer on the accumulator and return the score from the perspective of the side to move
+int NeuralNetwork::evaluate(const NNUEAccumulator &accumulator, int sideToMove) const
+{
+    // The first half of the output weights reads the neurons of the side to move, the second half those of the other side
+    const int16_t *pValues[2] = {accumulator.values[sideToMove], accumulator.values[sideToMove ^ 1]};
+    int sum = 0;
+
+    for (int half = 0; half < 2; half++)
+    {
+        const int16_t *pWeights = outputWeights + half * NNUE_HIDDEN;
+
+#ifdef NNUE_SIMD
+        Vector sums = zeroVector();
+
+        for (int neuron = 0; neuron < NNUE_HIDDEN; neuron += VECTOR_LANES)
+        {
+            sums = multiplyAddVectors(sums, clipVector(loadVector(pValues[half] + neuron)), loadVector(pWeights + neuron));
+        }
+
+        sum += sumVector(sums);
+#else
+        for (int neuron = 0; neuron < NNUE_HIDDEN; neuron++)
+        {
+            int value = pValues[half][neuron];
+            sum += ((value < 0) ? 0 : (value > NNUE_QA) ? NNUE_QA : value) * pWeights[neuron];
+        }
+#endif
+    }
+
+    return (int)((int64_t)(sum + outputBias) * NNUE_SCALE / (NNUE_QA * NNUE_QB));
+}
+
+/*
+Write a network that reproduces the material and piece-square scores of the hand-crafted evaluation, averaged over the game phases.
+Every neuron starts at the middle of the clipped ReLU range and moves by the scaled score of each piece, so the neurons of a
+perspective stay linear in its material balance up to about 30 pawns. The scaled scores are dithered across the neurons, so
+their sum rounds every feature exactly even though each weight is a small integer. It gives the network evaluator sensible
+play until a trained network replaces it.
+*/
+void writeBootstrapNetwork(const std::string &path)
+{
+    const int OUTPUT_WEIGHT = 2;
+    const int FEATURE_BIAS = (NNUE_QA + 1) / 2;
+
+    // Scale that turns the output of the network back into the averaged piece-square score
+    const double scale = (double)(NNUE_QA * NNUE_QB) / (2.0 * OUTPUT_WEIGHT * NNUE_HIDDEN * NNUE_SCALE);
+
+    std::vector<int16_t> featureWeights(NNUE_INPUTS * NNUE_HIDDEN);
+
+    for (int currentPiece = whitePawn; currentPiece <= blackKing; currentPiece++)
+    {
+        // Both kings are always on the board, so only their positional scores matter
+        int kingMaterial = (currentPiece % 6 == king) ? MATERIAL_SCORE[opening][currentPiece] + MATERIAL_SCORE[endgame][currentPiece] : 0;
+
+        for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+        {
+            int feature = currentPiece * 64 + squareIndex;
+            double score = (EVALUATION_TABLES.pieceSquareScore[opening][currentPiece][squareIndex] + EVALUATION_TABLES.pieceSquareScore[endgame][currentPiece][squareIndex] - kingMaterial) / 2.0;
+
+            for (int neuron = 0; neuron < NNUE_HIDDEN; neuron++)
+            {
+                double offset = (((neuron + feature * 97) % NNUE_HIDDEN) + 0.5) / NNUE_HIDDEN;
+                featureWeights[feature * NNUE_HIDDEN + neuron] = (int16_t)std::floor(score * scale + offset);
+            }
+        }
+    }
+
+    std::vector<int16_t> featureBiases(NNUE_HIDDEN, FEATURE_BIAS);
+    std::vector<int16_t> outputWeights(2 * NNUE_HIDDEN, OUTPUT_WEIGHT);
+    int32_t outputBias = 0;
+
+    // The side not to move sees the same balance from the other side, so its neurons count against the side to move
+    for (int neuron = NNUE_HIDDEN; neuron < 2 * NNUE_HIDDEN; neuron++)
+    {
+        outputWeights[neuron] = -OUTPUT_WEIGHT;
+    }
+
+    char header[NETWORK_HEADER_SIZE] = {0};
+    int32_t numInputs = NNUE_INPUTS, numHidden = NNUE_HIDDEN;
+
+    std::memcpy(header, NETWORK_MAGIC, sizeof(NETWORK_MAGIC));
+    std::memcpy(header + sizeof(NETWORK_MAGIC), &numInputs, sizeof(int32_t));
+    std::memcpy(header + sizeof(NETWORK_MAGIC) + sizeof(int32_t), &numHidden, sizeof(int32_t));
+
+    std::ofstream file(path, std::ios::binary);
+
+    file.write(header, NETWORK_HEADER_SIZE);
+    file.write(reinterpret_cast<const char *>(featureWeights.data()), featureWeights.size() * sizeof(int16_t));
+    file.write(reinterpret_cast<const char *>(featureBiases.data()), featureBiases.size() * sizeof(int16_t));
+    file.write(reinterpret_cast<const char *>(outputWeights.data()), outputWeights.size() * sizeof(int16_t));
+    file.write(reinterpret_cast<const char *>(&outputBias), sizeof(int32_t));
+
+    // Pad the weights to whole cache lines
+    std::vector<char> padding(NETWORK_FILE_SIZE - NETWORK_HEADER_SIZE - NETWORK_WEIGHTS_SIZE, 0);
+    file.write(padding.data(), padding.size());
+
+    if (!file)
+    {
+        throw CannotWriteNetworkException();
+    }
+}
@@ -0,0 +1,29 @@
+#include "PawnHashTable.h"
+
+// Forget all of the entries
+void PawnHashTable::clear()
+{
+    for (PawnHashEntry &entry : entries)
+    {
+        entry = PawnHashEntry();
+    }
+}
+
+// Reset the probe and hit counters
+void PawnHashTable::resetStatistics()
+{
+    probes = 0ULL;
+    hits = 0ULL;
+}
+
+// Get the number of probes since the statistics were reset
+U64 PawnHashTable::getProbes() const
+{
+    return probes;
+}
+
+// Get the number of probes that found their pawn configuration since the statistics were reset
+U64 PawnHashTable::getHits() const
+{
+    return hits;
+}
@@ -0,0 +1,148 @@
+#include <vector>
+#include <thread>
+
+#include "SearchThreads.h"
+#include "Position.h"
+#include "globals.h"
+
+// Class constructor to set the number of search threads
+SearchThreads::SearchThreads(int numThreads)
+{
+    setNumThreads(numThreads);
+}
+
+// Set the number of search threads
+void SearchThreads::setNumThreads(int numThreads)
+{
+    // At least the main thread has to search
+    this->numThreads = (numThreads < 1) ? 1 : numThreads;
+
+    pawnTables.resize(this->numThreads);
+}
+
+int SearchThreads::getNumThreads() const
+{
+    return numThreads;
+}
+
+// Evaluate with the given neural network, or with the hand-crafted evaluation if it is null
+void SearchThreads::setNetwork(const NeuralNetwork *pNetwork)
+{
+    this->pNetwork = pNetwork;
+}
+
+// Search the position with Lazy SMP and return the best move found by the main thread
+int SearchThreads::search(const std::string &fenString, int depth, bool fVerbose)
+{
+    // Every thread owns its board, killer moves, history moves, PV table and pawn hash table, only the transposition table and the evaluation cache are shared
+    std::vector<Position> positions(numThreads, Position(fenString));
+
+    fStop = false;
+
+    // Entries written from now on belong to the new search
+    TRANSPOSITION_TABLE.startNewSearch();
+
+    // Static evaluations of the same evaluator never go stale, so the cache is kept between searches
+    EVALUATION_CACHE.prepare();
+
+    // The cached evaluations of another evaluator, or of the weights the network held before it was loaded again, would be mixed with the new ones
+    EVALUATION_CACHE.setEvaluator(pNetwork ? pNetwork->getGeneration() : 0ULL);
+
+    for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+    {
+        positions[threadIndex].resetSearchVariables();
+        positions[threadIndex].setStopFlag(&fStop);
+        positions[threadIndex].setPawnHashTable(&pawnTables[threadIndex]);
+        positions[threadIndex].setNetwork(pNetwork);
+        pawnTables[threadIndex].resetStatistics();
+    }
+
+    // Start the helper threads, every other one searching a ply deeper to desynchronise the threads
+    std::vector<std::thread> helpers;
+
+    for (int threadIndex = 1; threadIndex < numThreads; threadIndex++)
+    {
+        helpers.emplace_back([&positions, threadIndex, depth]()
+                             { positions[threadIndex].iterativeDeepening(depth, threadIndex % 2, false); });
+    }
+
+    // The main thread searches on the calling thread, so a single threaded search never spawns a thread
+    positions[0].iterativeDeepening(depth, 0, fVerbose);
+
+    // Stop the helpers as soon as the main thread has completed its search
+    fStop = true;
+
+    for (std::thread &helper : helpers)
+    {
+        helper.join();
+    }
+
+    // Sum up the statistics of all of the threads
+    nodes = hashProbes = hashHits = pawnHashProbes = pawnHashHits = evalCacheProbes = evalCacheHits = 0ULL;
+
+    for (Position &position : positions)
+    {
+        nodes += position.getNodes();
+        hashProbes += position.getHashProbes();
+        hashHits += position.getHashHits();
+        evalCacheProbes += position.getEvalProbes();
+        evalCacheHits += position.getEvalHits();
+    }
+
+    for (PawnHashTable &pawnTable : pawnTables)
+    {
+        pawnHashProbes += pawnTable.getProbes();
+        pawnHashHits += pawnTable.getHits();
+    }
+
+    if (fVerbose)
+    {
+        std::cout << "\n\nBest Move: ";
+        printMove(positions[0].getBestMove());
+        std::cout << "\n";
+    }
+
+    return positions[0].getBestMove();
+}
+
+// Get the number of nodes visited during the last search
+U64 SearchThreads::getNodes() const
+{
+    return nodes;
+}
+
+// Get the number of transposition table probes during the last search
+U64 SearchThreads::getHashProbes() const
+{
+    return hashProbes;
+}
+
+// Get the number of transposition table probes that found an entry during the last search
+U64 SearchThreads::getHashHits() const
+{
+    return hashHits;
+}
+
+// Get the number of pawn hash table probes during the last search
+U64 SearchThreads::getPawnHashProbes() const
+{
+    return pawnHashProbes;
+}
+
+// Get the number of pawn hash table probes that found their pawn structure during the last search
+U64 SearchThreads::getPawnHashHits() const
+{
+    return pawnHashHits;
+}
+
+// Get the number of evaluation cache probes during the last search
+U64 SearchThreads::getEvalCacheProbes() const
+{
+    return evalCacheProbes;
+}
+
+// Get the number of evaluation cache probes that found their position during the last search
+U64 SearchThreads::getEvalCacheHits() const
+{
+    return evalCacheHits;
+}
@@ -0,0 +1,218 @@
+#include <cstdlib>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "TranspositionTable.h"
+#include "engine_exceptions.h"
+
+TranspositionTable::~TranspositionTable()
+{
+    release();
+}
+
+// Allocate memory for the given number of bytes of buckets, preferring huge pages, leaving the current table untouched
+TranspositionBucket *TranspositionTable::allocate(size_t size, size_t &allocatedSize, int &pageType)
+{
+#ifdef __linux__
+
+    // Round the size up to whole huge pages
+    size_t hugeSize = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+    // Explicit huge pages only exist if the administrator reserved them, so this fails quietly otherwise
+    void *pMemory = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (pMemory != MAP_FAILED)
+    {
+        allocatedSize = hugeSize;
+        pageType = explicitHugePages;
+        return static_cast<TranspositionBucket *>(pMemory);
+    }
+
+    // Otherwise align to the huge page size and ask the kernel to back the range with transparent huge pages
+    pMemory = std::aligned_alloc(HUGE_PAGE_SIZE, hugeSize);
+
+    if (pMemory)
+    {
+        allocatedSize = hugeSize;
+        pageType = (madvise(pMemory, hugeSize, MADV_HUGEPAGE) == 0) ? transparentHugePages : standardPages;
+        return static_cast<TranspositionBucket *>(pMemory);
+    }
+
+#endif
+
+    // Fall back to cache line aligned standard pages
+    void *pStandardMemory = std::aligned_alloc(alignof(TranspositionBucket), size);
+
+    if (!pStandardMemory)
+    {
+        throw CannotAllocateHashTableException();
+    }
+
+    allocatedSize = size;
+    pageType = standardPages;
+    return static_cast<TranspositionBucket *>(pStandardMemory);
+}
+
+// Release the memory of the buckets
+void TranspositionTable::release()
+{
+    if (!buckets)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    if (pageType == explicitHugePages)
+    {
+        munmap(buckets, allocatedSize);
+    }
+    else
+    {
+        std::free(buckets);
+    }
+#else
+    std::free(buckets);
+#endif
+
+    buckets = nullptr;
+    numBuckets = 0;
+    allocatedSize = 0;
+}
+
+// Reallocate the table with the given size in megabytes and clear it
+void TranspositionTable::resize(int megabytes)
+{
+    // At least one megabyte is always allocated
+    size_t size = (size_t)((megabytes < 1) ? 1 : megabytes) * 1024 * 1024;
+
+    // Allocate the new table first, so a failed allocation throws with the old table still in place
+    size_t newAllocatedSize = 0;
+    int newPageType = standardPages;
+    TranspositionBucket *pNewBuckets = allocate(size, newAllocatedSize, newPageType);
+    U64 newNumBuckets = size / sizeof(TranspositionBucket);
+
+    // Construct the empty buckets in the raw memory
+    for (U64 bucketIndex = 0; bucketIndex < newNumBuckets; bucketIndex++)
+    {
+        new (&pNewBuckets[bucketIndex]) TranspositionBucket();
+    }
+
+    release();
+
+    buckets = pNewBuckets;
+    numBuckets = newNumBuckets;
+    allocatedSize = newAllocatedSize;
+    pageType = newPageType;
+    generation = 0;
+}
+
+// Remove all of the entries
+void TranspositionTable::clear()
+{
+    // Allocate the default table if none has been requested yet
+    if (!buckets)
+    {
+        resize(DEFAULT_TT_MEGABYTES);
+        return;
+    }
+
+    for (U64 bucketIndex = 0; bucketIndex < numBuckets; bucketIndex++)
+    {
+        for (TranspositionNode &node : buckets[bucketIndex].nodes)
+        {
+            node.save(0ULL, 0ULL);
+        }
+    }
+
+    generation = 0;
+}
+
+// Advance the generation at the start of every search
+void TranspositionTable::startNewSearch()
+{
+    if (!buckets)
+    {
+        resize(DEFAULT_TT_MEGABYTES);
+    }
+
+    generation = (generation + 1) % TT_GENERATIONS;
+}
+
+// Find the data word stored for the hash key, returning false if there is none
+bool TranspositionTable::probe(U64 hashKey, U64 &hashData)
+{
+    TranspositionBucket *pBucket = getBucket(hashKey);
+
+    // Loop over the nodes of the bucket
+    for (TranspositionNode &node : pBucket->nodes)
+    {
+        // Return the first node that validates against the key
+        if (node.load(hashKey, hashData))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Store an entry, replacing the shallowest and oldest node of the bucket
+void TranspositionTable::store(U64 hashKey, int move, int score, int depth, int flag)
+{
+    TranspositionBucket *pBucket = getBucket(hashKey);
+    TranspositionNode *pReplace = &pBucket->nodes[0];
+
+    int lowestValue = INF;
+
+    // Loop over the nodes of the bucket
+    for (TranspositionNode &node : pBucket->nodes)
+    {
+        U64 nodeData;
+
+        // If the position is already stored, overwrite it unless the new entry is a much shallower bound from the same search
+        if (node.load(hashKey, nodeData))
+        {
+            if (flag != fPV_HASH && depth + 2 < getHashDepth(nodeData) && getHashGeneration(nodeData) == generation)
+            {
+                return;
+            }
+
+            // A fail-low node has no best move, so keep the move found by the earlier search
+            if (!move)
+            {
+                move = getHashMove(nodeData);
+            }
+
+            pReplace = &node;
+            break;
+        }
+
+        // Every generation of age weighs as much as eight plies of depth
+        int age = (generation - getHashGeneration(nodeData) + TT_GENERATIONS) % TT_GENERATIONS;
+        int value = getHashDepth(nodeData) - 8 * age;
+
+        // Record the least valuable node
+        if (value < lowestValue)
+        {
+            lowestValue = value;
+            pReplace = &node;
+        }
+    }
+
+    pReplace->save(hashKey, packHashData(move, score, depth, flag, generation));
+}
+
+// Get the size of the table in megabytes
+int TranspositionTable::getMegabytes() const
+{
+    return (int)(numBuckets * sizeof(TranspositionBucket) / (1024 * 1024));
+}
+
+// Get the kind of memory backing the table
+int TranspositionTable::getPageType() const
+{
+    return pageType;
+}
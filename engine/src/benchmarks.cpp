@@ -0,0 +1,1114 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <random>
+#include <memory>
+
+#include "benchmarks.h"
+#include "SearchThreads.h"
+#include "Position.h"
+#include "Board.h"
+#include "globals.h"
+#include "magic_numbers.h"
+#include "bitboard_operations.h"
+#include "kogge_stone.h"
+#include "const.h"
+
+using std::cout, std::string;
+
+// Positions searched by the benchmarks
+const string BENCHMARK_POSITIONS_FEN[4] = {
+    START_POSITION_FEN,
+    TEST_POSITIONS_FEN[0],
+    TEST_POSITIONS_FEN[1],
+    TEST_POSITIONS_FEN[2]
+};
+
+// Known perft leaf counts of the benchmark positions at depths 1 to 4
+const U64 PERFT_RESULTS[4][4] = {
+    {20ULL, 400ULL, 8902ULL, 197281ULL},
+    {48ULL, 2039ULL, 97862ULL, 4085603ULL},
+    {14ULL, 191ULL, 2812ULL, 43238ULL},
+    {6ULL, 264ULL, 9467ULL, 422333ULL}
+};
+
+// Number of rounds the prefetch benchmark runs each way
+const int HASH_PREFETCH_ROUNDS = 5;
+
+// Names of the sliding piece attack backends
+const string SLIDER_BACKEND_NAMES[3] = {"magic", "PEXT", "Kogge-Stone"};
+
+// Print the size of the transposition table and the kind of pages backing it, the size of the evaluation cache and the slider attack backend
+static void printHashTableInfo()
+{
+    const string PAGE_TYPE_NAMES[3] = {"standard pages", "transparent huge pages", "explicit huge pages"};
+    EVALUATION_CACHE.prepare();
+
+    cout << "Hash: " << TRANSPOSITION_TABLE.getMegabytes() << " MB, " << PAGE_TYPE_NAMES[TRANSPOSITION_TABLE.getPageType()] << '\n';
+    cout << "Evaluation cache: " << EVALUATION_CACHE.getMegabytes() << " MB\n";
+    cout << "Slider attacks: " << SLIDER_BACKEND_NAMES[AttackTable::getSliderBackend()] << "\n\n";
+}
+
+// Search the benchmark positions to a fixed depth and report time to depth, nodes, NPS and the hash hit rates, evaluating with the network if one is given
+void benchmarkSearch(int depth, const NeuralNetwork *pNetwork)
+{
+    cout << "\n    Search benchmark (depth " << depth << ")\n\n";
+    printHashTableInfo();
+    cout << std::setw(10) << "Position" << std::setw(12) << "Time (ms)" << std::setw(14) << "Nodes"
+         << std::setw(12) << "NPS" << std::setw(14) << "TT hit rate" << std::setw(16) << "Pawn hit rate" << std::setw(16) << "Eval hit rate" << '\n';
+
+    SearchThreads threads(1);
+    threads.setNetwork(pNetwork);
+
+    U64 totalNodes = 0ULL, totalProbes = 0ULL, totalHits = 0ULL, totalPawnProbes = 0ULL, totalPawnHits = 0ULL, totalEvalProbes = 0ULL, totalEvalHits = 0ULL;
+    double totalSeconds = 0.0;
+
+    for (int positionIndex = 0; positionIndex < 4; positionIndex++)
+    {
+        TRANSPOSITION_TABLE.clear();
+        EVALUATION_CACHE.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        threads.search(BENCHMARK_POSITIONS_FEN[positionIndex], depth, false);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        totalNodes += threads.getNodes();
+        totalProbes += threads.getHashProbes();
+        totalHits += threads.getHashHits();
+        totalPawnProbes += threads.getPawnHashProbes();
+        totalPawnHits += threads.getPawnHashHits();
+        totalEvalProbes += threads.getEvalCacheProbes();
+        totalEvalHits += threads.getEvalCacheHits();
+        totalSeconds += seconds;
+
+        cout << std::setw(10) << positionIndex + 1
+             << std::setw(12) << (U64)(seconds * 1000)
+             << std::setw(14) << threads.getNodes()
+             << std::setw(12) << (U64)(threads.getNodes() / seconds)
+             << std::setw(13) << std::fixed << std::setprecision(1) << 100.0 * threads.getHashHits() / std::max(threads.getHashProbes(), 1ULL) << "%"
+             << std::setw(15) << 100.0 * threads.getPawnHashHits() / std::max(threads.getPawnHashProbes(), 1ULL) << "%"
+             << std::setw(15) << 100.0 * threads.getEvalCacheHits() / std::max(threads.getEvalCacheProbes(), 1ULL) << "%\n";
+    }
+
+    cout << std::setw(10) << "Total"
+         << std::setw(12) << (U64)(totalSeconds * 1000)
+         << std::setw(14) << totalNodes
+         << std::setw(12) << (U64)(totalNodes / totalSeconds)
+         << std::setw(13) << std::fixed << std::setprecision(1) << 100.0 * totalHits / std::max(totalProbes, 1ULL) << "%"
+         << std::setw(15) << 100.0 * totalPawnHits / std::max(totalPawnProbes, 1ULL) << "%"
+         << std::setw(15) << 100.0 * totalEvalHits / std::max(totalEvalProbes, 1ULL) << "%\n\n";
+}
+
+// Count the perft leaves of the benchmark positions and report the time and leaves per second
+void benchmarkPerft(int depth)
+{
+    cout << "\n    Perft benchmark (depth " << depth << ")\n\n";
+    cout << std::setw(10) << "Position" << std::setw(12) << "Time (ms)" << std::setw(14) << "Leaves" << std::setw(14) << "Leaves/s" << '\n';
+
+    U64 totalLeaves = 0ULL;
+    double totalSeconds = 0.0;
+
+    for (int positionIndex = 0; positionIndex < 4; positionIndex++)
+    {
+        Position position(BENCHMARK_POSITIONS_FEN[positionIndex]);
+
+        auto start = std::chrono::steady_clock::now();
+        U64 leaves = position.perft(depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        totalLeaves += leaves;
+        totalSeconds += seconds;
+
+        cout << std::setw(10) << positionIndex + 1
+             << std::setw(12) << (U64)(seconds * 1000)
+             << std::setw(14) << leaves
+             << std::setw(14) << (U64)(leaves / seconds) << '\n';
+    }
+
+    cout << std::setw(10) << "Total"
+         << std::setw(12) << (U64)(totalSeconds * 1000)
+         << std::setw(14) << totalLeaves
+         << std::setw(14) << (U64)(totalLeaves / totalSeconds) << "\n\n";
+}
+
+// Measure the average cost of making and unmaking the moves of the benchmark positions
+void benchmarkMakeMove(int numIterations)
+{
+    cout << "\n    Make/unmake benchmark (" << numIterations << " iterations)\n\n";
+
+    U64 hashSum = 0ULL, numMoves = 0ULL;
+    double seconds = 0.0;
+
+    for (const string &fenString : BENCHMARK_POSITIONS_FEN)
+    {
+        Board board(fenString);
+        MoveList moves = board.generateMoves();
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int iteration = 0; iteration < numIterations; iteration++)
+        {
+            for (int moveIndex = 0; moveIndex < moves.getCount(); moveIndex++)
+            {
+                UndoInfo undo;
+
+                board.makeMove(moves.getMoves()[moveIndex], undo);
+                hashSum += board.getHashKey();
+                board.unmakeMove(moves.getMoves()[moveIndex], undo);
+            }
+        }
+
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        numMoves += (U64)moves.getCount() * numIterations;
+    }
+
+    cout << "Moves: " << numMoves << '\n';
+    cout << "Make + unmake: " << std::fixed << std::setprecision(2) << seconds * 1e9 / numMoves << " ns per move\n";
+
+    // Print the accumulated keys so the compiler cannot drop the loop
+    cout << "\n(checksum " << hashSum << ")\n\n";
+}
+
+// Measure the average cost of the hand-crafted and the network evaluation over the benchmark positions and the positions up to two plies from them
+void benchmarkEvaluation(int numIterations, const NeuralNetwork *pNetwork)
+{
+    cout << "\n    Evaluation benchmark (" << numIterations << " iterations)\n\n";
+
+    // Share one pawn hash table between the boards, as a search thread does
+    PawnHashTable pawnTable;
+    std::vector<Board> boards;
+
+    for (const string &fenString : BENCHMARK_POSITIONS_FEN)
+    {
+        Board board(fenString);
+        board.setPawnHashTable(&pawnTable);
+        boards.push_back(board);
+
+        MoveList moves = board.generateMoves();
+
+        for (int moveIndex = 0; moveIndex < moves.getCount(); moveIndex++)
+        {
+            UndoInfo undo;
+
+            board.makeMove(moves.getMoves()[moveIndex], undo);
+            boards.push_back(board);
+
+            MoveList replies = board.generateMoves();
+
+            for (int replyIndex = 0; replyIndex < replies.getCount(); replyIndex++)
+            {
+                UndoInfo replyUndo;
+
+                board.makeMove(replies.getMoves()[replyIndex], replyUndo);
+                boards.push_back(board);
+                board.unmakeMove(replies.getMoves()[replyIndex], replyUndo);
+            }
+
+            board.unmakeMove(moves.getMoves()[moveIndex], undo);
+        }
+    }
+
+    long long scoreSum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < numIterations; iteration++)
+    {
+        for (Board &board : boards)
+        {
+            // A search evaluates every position once, so the attack maps are never reused from the previous iteration
+            board.clearAttackInfo();
+            scoreSum += board.staticEvaluate();
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    U64 numEvaluations = (U64)boards.size() * numIterations;
+
+    cout << "Positions: " << boards.size() << '\n';
+    cout << "Evaluations: " << numEvaluations << '\n';
+    cout << "Static evaluation: " << std::fixed << std::setprecision(2) << seconds * 1e9 / numEvaluations << " ns per position, "
+         << (U64)(numEvaluations / seconds) << " per second\n";
+
+    // Generate the legal moves of the same positions, whose check and pin masks are computed afresh as at a new node
+    start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < numIterations; iteration++)
+    {
+        for (Board &board : boards)
+        {
+            board.clearAttackInfo();
+            scoreSum += board.generateMoves().getCount();
+        }
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << "Move generation: " << seconds * 1e9 / numEvaluations << " ns per position, "
+         << (U64)(numEvaluations / seconds) << " per second\n";
+
+    if (pNetwork)
+    {
+        // Fill the accumulators of all of the boards from scratch
+        start = std::chrono::steady_clock::now();
+
+        for (Board &board : boards)
+        {
+            board.setNetwork(pNetwork);
+        }
+
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        cout << "Accumulator refresh: " << seconds * 1e9 / boards.size() << " ns per position\n";
+
+        // A search reaches every position with its accumulator already updated by the move, leaving only the output layer
+        start = std::chrono::steady_clock::now();
+
+        for (int iteration = 0; iteration < numIterations; iteration++)
+        {
+            for (Board &board : boards)
+            {
+                scoreSum += board.evaluate();
+            }
+        }
+
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        cout << "Network evaluation: " << seconds * 1e9 / numEvaluations << " ns per position, "
+             << (U64)(numEvaluations / seconds) << " per second\n";
+
+        // Compare the cost of making and unmaking the root moves with and without the accumulator updates
+        double makeSeconds[2] = {0.0, 0.0};
+        U64 numMoves = 0ULL;
+
+        for (const string &fenString : BENCHMARK_POSITIONS_FEN)
+        {
+            Board board(fenString);
+            MoveList moves = board.generateMoves();
+
+            for (int fNetwork = 0; fNetwork < 2; fNetwork++)
+            {
+                board.setNetwork(fNetwork ? pNetwork : nullptr);
+
+                start = std::chrono::steady_clock::now();
+
+                for (int iteration = 0; iteration < numIterations * 10; iteration++)
+                {
+                    for (int moveIndex = 0; moveIndex < moves.getCount(); moveIndex++)
+                    {
+                        UndoInfo undo;
+
+                        board.makeMove(moves.getMoves()[moveIndex], undo);
+                        scoreSum += board.getHashKey() & 1;
+                        board.unmakeMove(moves.getMoves()[moveIndex], undo);
+                    }
+                }
+
+                makeSeconds[fNetwork] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+
+            numMoves += (U64)moves.getCount() * numIterations * 10;
+        }
+
+        cout << "Make + unmake: " << makeSeconds[0] * 1e9 / numMoves << " ns per move, "
+             << makeSeconds[1] * 1e9 / numMoves << " ns with the accumulator updates\n";
+    }
+
+    // Print the accumulated scores so the compiler cannot drop the loop
+    cout << "\n(checksum " << scoreSum << ")\n\n";
+}
+
+// Measure the Lazy SMP speedup and nodes per second for 1 up to maxThreads threads
+void benchmarkLazySMP(int maxThreads, int depth)
+{
+    cout << "\n    Lazy SMP benchmark (depth " << depth << ")\n\n";
+    printHashTableInfo();
+    cout << std::setw(8) << "Threads" << std::setw(12) << "Time (ms)" << std::setw(14) << "Nodes"
+         << std::setw(12) << "NPS" << std::setw(10) << "Speedup" << '\n';
+
+    double singleThreadSeconds = 0.0;
+
+    // Double the number of threads each run, making sure the requested maximum is measured as well
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads = (numThreads * 2 > maxThreads && numThreads != maxThreads) ? maxThreads : numThreads * 2)
+    {
+        SearchThreads threads(numThreads);
+
+        U64 nodes = 0ULL;
+        double seconds = 0.0;
+
+        for (const string &fenString : BENCHMARK_POSITIONS_FEN)
+        {
+            // Every search starts from an empty table and cache so the runs are comparable
+            TRANSPOSITION_TABLE.clear();
+            EVALUATION_CACHE.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            threads.search(fenString, depth, false);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            nodes += threads.getNodes();
+        }
+
+        if (numThreads == 1)
+        {
+            singleThreadSeconds = seconds;
+        }
+
+        cout << std::setw(8) << numThreads
+             << std::setw(12) << (U64)(seconds * 1000)
+             << std::setw(14) << nodes
+             << std::setw(12) << (U64)(nodes / seconds)
+             << std::setw(9) << std::fixed << std::setprecision(2) << singleThreadSeconds / seconds << "x\n";
+    }
+
+    cout << '\n';
+}
+
+// Count the bits one at a time, as the bit operations did before they used the hardware instructions
+static int countBitsInLoop(U64 bitboard)
+{
+    int populationCount = 0;
+
+    while (bitboard)
+    {
+        // The empty statement hides the loop from the compiler, which would otherwise recognise it and emit POPCNT itself
+        asm volatile("" : "+r"(bitboard));
+
+        populationCount++;
+        bitboard &= bitboard - 1;
+    }
+
+    return populationCount;
+}
+
+// Measure the startup work left at runtime, against building the compile-time tables and searching for the magic numbers as earlier starts did
+void benchmarkStartup(int numIterations)
+{
+    cout << "\n    Startup benchmark (" << numIterations << " iterations)\n\n";
+
+    // Check the built-in magic numbers against every occupancy of their squares
+    int numValid = 0;
+
+    for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+    {
+        numValid += isMagicNumberValid(squareIndex, BISHOP_RELEVANT_BITS[squareIndex], true, BISHOP_MAGIC_NUMBERS[squareIndex]);
+        numValid += isMagicNumberValid(squareIndex, ROOK_RELEVANT_BITS[squareIndex], false, ROOK_MAGIC_NUMBERS[squareIndex]);
+    }
+
+    cout << "Built-in magic numbers: " << numValid << " of 128 valid\n";
+
+    // The tables are generated at compile time, so a process maps them from the binary instead of building them
+    cout << "Compile-time tables: " << (sizeof(AttackTable) + sizeof(EvaluationTables)) / 1024 << " KB read-only\n";
+
+    U64 checksum = 0ULL;
+
+    // Build the same tables at runtime, as every start did before they were generated at compile time
+    auto start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < numIterations; iteration++)
+    {
+        std::unique_ptr<AttackTable> pAttacks = std::make_unique<AttackTable>();
+        std::unique_ptr<EvaluationTables> pTables = std::make_unique<EvaluationTables>();
+        checksum += pAttacks->getQueenAttacks(iteration % 64, 0ULL) + pTables->whitePassedPawnMasks[iteration % 64];
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << "Tables built at runtime: " << std::fixed << std::setprecision(2) << seconds * 1e3 / numIterations << " ms\n";
+
+    // Generate the hash keys, the only table main still fills at startup
+    start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < numIterations; iteration++)
+    {
+        generateKeys();
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << "Hash keys: " << seconds * 1e3 / numIterations << " ms\n";
+
+    // Search for the magic numbers of all of the squares once, as every start did before they were built in
+    start = std::chrono::steady_clock::now();
+
+    for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+    {
+        checksum += findMagicNumber(squareIndex, BISHOP_RELEVANT_BITS[squareIndex], true);
+        checksum += findMagicNumber(squareIndex, ROOK_RELEVANT_BITS[squareIndex], false);
+    }
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    cout << "Magic number search: " << seconds * 1e3 << " ms\n";
+
+    // Print the checksum so the compiler cannot drop the loops
+    cout << "\n(checksum " << checksum << ")\n\n";
+}
+
+// Measure the hardware population count, LS1B and pop-LSB against the loops they replaced
+void benchmarkBitScans(int numIterations)
+{
+    cout << "\n    Bit scan benchmark (" << numIterations << " iterations)\n\n";
+
+    // Sparse and dense bitboards, like the piece sets and the attack sets the engine scans
+    std::vector<U64> bitboards(4096);
+    std::mt19937_64 generator(4096);
+
+    for (size_t bitboardIndex = 0; bitboardIndex < bitboards.size(); bitboardIndex++)
+    {
+        bitboards[bitboardIndex] = (bitboardIndex % 2) ? generator() & generator() : generator() & generator() & generator() & generator();
+    }
+
+    U64 checksums[2][2] = {{0ULL, 0ULL}, {0ULL, 0ULL}};
+    double seconds[2][2];
+    U64 numBits = 0ULL;
+
+    for (U64 bitboard : bitboards)
+    {
+        numBits += getPopulationCount(bitboard);
+    }
+
+    for (int fHardware = 0; fHardware <= 1; fHardware++)
+    {
+        // Count the bits of every bitboard
+        auto start = std::chrono::steady_clock::now();
+
+        for (int iteration = 0; iteration < numIterations; iteration++)
+        {
+            for (U64 bitboard : bitboards)
+            {
+                checksums[fHardware][0] += fHardware ? getPopulationCount(bitboard) : countBitsInLoop(bitboard);
+            }
+        }
+
+        seconds[fHardware][0] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Visit every square of every bitboard, the way the move generation and the evaluation walk their sets
+        start = std::chrono::steady_clock::now();
+
+        for (int iteration = 0; iteration < numIterations; iteration++)
+        {
+            for (U64 bitboard : bitboards)
+            {
+                while (bitboard)
+                {
+                    if (fHardware)
+                    {
+                        checksums[fHardware][1] += popLSB(bitboard);
+                    }
+                    else
+                    {
+                        int squareIndex = countBitsInLoop((bitboard & -bitboard) - 1);
+                        checksums[fHardware][1] += squareIndex;
+                        bitboard ^= 1ULL << squareIndex;
+                    }
+                }
+            }
+        }
+
+        seconds[fHardware][1] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    U64 numBitboards = (U64)bitboards.size() * numIterations;
+
+    cout << "Bitboards: " << numBitboards << ", " << std::fixed << std::setprecision(1) << (double)numBits / bitboards.size() << " bits on average\n\n";
+    cout << std::setw(22) << "" << std::setw(12) << "Loop" << std::setw(12) << "Hardware" << '\n';
+    cout << std::setw(22) << "Population count (ns)" << std::setprecision(2)
+         << std::setw(12) << seconds[0][0] * 1e9 / numBitboards << std::setw(12) << seconds[1][0] * 1e9 / numBitboards << '\n';
+    cout << std::setw(22) << "Pop-LSB walk (ns)"
+         << std::setw(12) << seconds[0][1] * 1e9 / numBitboards << std::setw(12) << seconds[1][1] * 1e9 / numBitboards << '\n';
+    cout << "\nResults " << ((checksums[0][0] == checksums[1][0] && checksums[0][1] == checksums[1][1]) ? "agree" : "DIFFER") << '\n';
+
+    // Print the accumulated values so the compiler cannot drop the loops
+    cout << "\n(checksum " << (checksums[1][0] ^ checksums[1][1]) << ")\n\n";
+}
+
+// Measure the rook and bishop attack lookups of the backends the build offers on random occupancies, checking that they agree
+void benchmarkSliderLookups(int numIterations)
+{
+    cout << "\n    Slider lookup benchmark (" << numIterations << " iterations)\n\n";
+
+    // Random squares and occupancies of about a quarter of the board, like the middlegame positions the search visits
+    std::vector<int> squares(4096);
+    std::vector<U64> occupancies(4096);
+    std::mt19937_64 generator(4096);
+
+    for (size_t lookupIndex = 0; lookupIndex < squares.size(); lookupIndex++)
+    {
+        squares[lookupIndex] = generator() % 64;
+        occupancies[lookupIndex] = generator() & generator();
+    }
+
+    int defaultBackend = AttackTable::getSliderBackend();
+    bool fSupported[3] = {false, false, false};
+    U64 checksums[3][2] = {{0ULL, 0ULL}, {0ULL, 0ULL}, {0ULL, 0ULL}};
+    double seconds[3][2] = {{0.0, 0.0}, {0.0, 0.0}, {0.0, 0.0}};
+
+    for (int backend = magicSliders; backend <= koggeStoneSliders; backend++)
+    {
+        fSupported[backend] = AttackTable::setSliderBackend(backend);
+
+        if (!fSupported[backend])
+        {
+            continue;
+        }
+
+        for (int fRook = 0; fRook <= 1; fRook++)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            for (int iteration = 0; iteration < numIterations; iteration++)
+            {
+                for (size_t lookupIndex = 0; lookupIndex < squares.size(); lookupIndex++)
+                {
+                    U64 attacks = fRook ? ATTACKS.getRookAttacks(squares[lookupIndex], occupancies[lookupIndex])
+                                        : ATTACKS.getBishopAttacks(squares[lookupIndex], occupancies[lookupIndex]);
+
+                    checksums[backend][fRook] += attacks;
+                }
+            }
+
+            seconds[backend][fRook] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    AttackTable::setSliderBackend(defaultBackend);
+
+    U64 numLookups = (U64)squares.size() * numIterations;
+
+    cout << "Default backend: " << SLIDER_BACKEND_NAMES[defaultBackend] << '\n';
+
+    // Every square only takes the entries its relevant bits index, packed into one table per backend
+    if (defaultBackend == koggeStoneSliders)
+    {
+        cout << "Attack table per backend: none, the attacks are filled\n\n";
+    }
+    else
+    {
+        cout << "Attack table per backend: " << SLIDER_TABLE_SIZE * sizeof(U64) / 1024 << " KB\n\n";
+    }
+
+    cout << std::setw(22) << "";
+
+    for (int backend = magicSliders; backend <= koggeStoneSliders; backend++)
+    {
+        cout << std::setw(14) << SLIDER_BACKEND_NAMES[backend];
+    }
+
+    cout << '\n';
+
+    for (int fRook = 1; fRook >= 0; fRook--)
+    {
+        cout << std::setw(22) << (fRook ? "Rook lookup (ns)" : "Bishop lookup (ns)") << std::fixed << std::setprecision(2);
+
+        for (int backend = magicSliders; backend <= koggeStoneSliders; backend++)
+        {
+            if (fSupported[backend])
+            {
+                cout << std::setw(14) << seconds[backend][fRook] * 1e9 / numLookups;
+            }
+            else
+            {
+                cout << std::setw(14) << "n/a";
+            }
+        }
+
+        cout << '\n';
+    }
+
+    // Every backend the build and the CPU run must give the attacks of the default one
+    bool fAgree = true;
+    int numSupported = 0;
+
+    for (int backend = magicSliders; backend <= koggeStoneSliders; backend++)
+    {
+        if (fSupported[backend])
+        {
+            numSupported++;
+            fAgree &= checksums[backend][0] == checksums[defaultBackend][0] && checksums[backend][1] == checksums[defaultBackend][1];
+        }
+    }
+
+    if (numSupported > 1)
+    {
+        cout << "\nResults " << (fAgree ? "agree" : "DIFFER") << '\n';
+    }
+    else
+    {
+        cout << "\nOnly the " << SLIDER_BACKEND_NAMES[defaultBackend] << " backend runs on this build and CPU\n";
+    }
+
+    // Print the accumulated attacks so the compiler cannot drop the loops
+    cout << "\n(checksum " << (checksums[defaultBackend][0] ^ checksums[defaultBackend][1]) << ")\n\n";
+}
+
+// Get the squares attacked by the bishops, rooks and queens of both sides, looked up one piece at a time
+static U64 getSliderAttackMapByPiece(const U64 *bitboards, U64 occupancy)
+{
+    U64 diagonalSliders = bitboards[whiteBishop] | bitboards[whiteQueen] | bitboards[blackBishop] | bitboards[blackQueen];
+    U64 orthogonalSliders = bitboards[whiteRook] | bitboards[whiteQueen] | bitboards[blackRook] | bitboards[blackQueen];
+    U64 attacks = 0ULL;
+
+    while (diagonalSliders)
+    {
+        attacks |= ATTACKS.getBishopAttacks(popLSB(diagonalSliders), occupancy);
+    }
+
+    while (orthogonalSliders)
+    {
+        attacks |= ATTACKS.getRookAttacks(popLSB(orthogonalSliders), occupancy);
+    }
+
+    return attacks;
+}
+
+/*
+Measure a whole-board attack map of the sliding pieces, every square the bishops, rooks and queens of both sides attack,
+over the benchmark positions and the positions a move away from them: fetched piece by piece from the attack table of the build,
+filled piece by piece, and filled as two sets, once with the scalar fills and once with the vector fills if the target has them.
+The attack maps the engine computes for both sides, which count the mobility as well, are timed alongside.
+*/
+void benchmarkAttackMaps(int numIterations)
+{
+    cout << "\n    Attack map benchmark (" << numIterations << " iterations)\n\n";
+
+    std::vector<Board> boards;
+
+    for (const string &fenString : BENCHMARK_POSITIONS_FEN)
+    {
+        Board board(fenString);
+        boards.push_back(board);
+
+        MoveList moves = board.generateMoves();
+
+        for (int moveIndex = 0; moveIndex < moves.getCount(); moveIndex++)
+        {
+            UndoInfo undo;
+
+            board.makeMove(moves.getMoves()[moveIndex], undo);
+            boards.push_back(board);
+            board.unmakeMove(moves.getMoves()[moveIndex], undo);
+        }
+    }
+
+#ifdef FILL_SIMD
+    const bool fVectorFills = true;
+#else
+    const bool fVectorFills = false;
+#endif
+
+    const string METHOD_NAMES[5] = {"AttackTable by piece", "Scalar fills by piece", "Scalar fills by set", "Vector fills by set", "Engine attack maps"};
+    const int VECTOR_METHOD = 3, ENGINE_METHOD = 4;
+
+    U64 checksums[5] = {0ULL, 0ULL, 0ULL, 0ULL, 0ULL};
+    double seconds[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+    for (int method = 0; method < 5; method++)
+    {
+        if (method == VECTOR_METHOD && !fVectorFills)
+        {
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int iteration = 0; iteration < numIterations; iteration++)
+        {
+            for (Board &board : boards)
+            {
+                const U64 *bitboards = board.getBitboards();
+                U64 occupancy = 0ULL;
+
+                for (int currentPiece = whitePawn; currentPiece <= blackKing; currentPiece++)
+                {
+                    occupancy |= bitboards[currentPiece];
+                }
+
+                U64 diagonalSliders = bitboards[whiteBishop] | bitboards[whiteQueen] | bitboards[blackBishop] | bitboards[blackQueen];
+                U64 orthogonalSliders = bitboards[whiteRook] | bitboards[whiteQueen] | bitboards[blackRook] | bitboards[blackQueen];
+
+                switch (method)
+                {
+                case 0:
+                    checksums[method] += getSliderAttackMapByPiece(bitboards, occupancy);
+                    break;
+                case 1:
+                {
+                    U64 attacks = 0ULL;
+
+                    while (diagonalSliders)
+                    {
+                        attacks |= getBishopFillAttacks(1ULL << popLSB(diagonalSliders), occupancy);
+                    }
+
+                    while (orthogonalSliders)
+                    {
+                        attacks |= getRookFillAttacks(1ULL << popLSB(orthogonalSliders), occupancy);
+                    }
+
+                    checksums[method] += attacks;
+                    break;
+                }
+                case 2:
+                    checksums[method] += getBishopFillAttacks(diagonalSliders, occupancy) | getRookFillAttacks(orthogonalSliders, occupancy);
+                    break;
+#ifdef FILL_SIMD
+                case 3:
+                    checksums[method] += getBishopFillAttacksSimd(diagonalSliders, occupancy) | getRookFillAttacksSimd(orthogonalSliders, occupancy);
+                    break;
+#endif
+                default:
+                {
+                    // Drop the cached maps, so every iteration computes them again
+                    board.clearAttackInfo();
+                    const AttackInfo &info = board.getAttacks(white);
+                    checksums[method] += info.pieceAttacks[whiteBishop] | info.pieceAttacks[whiteRook] | info.pieceAttacks[whiteQueen];
+                    board.getAttacks(black);
+                    checksums[method] += info.pieceAttacks[blackBishop] | info.pieceAttacks[blackRook] | info.pieceAttacks[blackQueen];
+                    break;
+                }
+                }
+            }
+        }
+
+        seconds[method] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    U64 numMaps = (U64)boards.size() * numIterations;
+
+    cout << "Positions: " << boards.size() << '\n';
+    cout << "Slider attacks: " << SLIDER_BACKEND_NAMES[AttackTable::getSliderBackend()] << '\n';
+
+#ifdef FILL_SIMD
+    cout << "Vector fills: " << FILL_SIMD_NAME << "\n\n";
+#else
+    cout << "Vector fills: none on this target\n\n";
+#endif
+
+    for (int method = 0; method < 5; method++)
+    {
+        if (method == VECTOR_METHOD && !fVectorFills)
+        {
+            continue;
+        }
+
+        cout << std::setw(24) << METHOD_NAMES[method] << ": " << std::fixed << std::setprecision(2) << seconds[method] * 1e9 / numMaps << " ns per position\n";
+    }
+
+    // Every method gives the same map, while the engine maps are summed per side and only timed
+    bool fAgree = true;
+
+    for (int method = 1; method < ENGINE_METHOD; method++)
+    {
+        fAgree &= (method == VECTOR_METHOD && !fVectorFills) || checksums[method] == checksums[0];
+    }
+
+    cout << "\nResults " << (fAgree ? "agree" : "DIFFER") << '\n';
+
+    // Print the accumulated attack maps so the compiler cannot drop the loops
+    cout << "\n(checksum " << (checksums[0] ^ checksums[ENGINE_METHOD]) << ")\n\n";
+}
+
+// Measure the latency of transposition table probes with and without a prefetch issued ahead of them
+void benchmarkHashPrefetch(int numProbes)
+{
+    cout << "\n    Hash prefetch benchmark (" << numProbes << " probes)\n\n";
+    printHashTableInfo();
+
+    std::vector<U64> keys(numProbes);
+    std::mt19937_64 generator(numProbes);
+
+    for (U64 &key : keys)
+    {
+        key = generator();
+    }
+
+    // Fill the table so the probes walk real entries
+    for (U64 key : keys)
+    {
+        TRANSPOSITION_TABLE.store(key, 0, 0, 1, fPV_HASH);
+    }
+
+    U64 hashData, work = 0ULL, hits = 0ULL;
+
+    // Best time of each run, with and without the prefetch
+    double bestSeconds[2] = {1e30, 1e30};
+
+    // The runs alternate and swap their order every round, so neither always meets the table in the cache state the other left
+    for (int round = 0; round < HASH_PREFETCH_ROUNDS; round++)
+    {
+        for (int runIndex = 0; runIndex <= 1; runIndex++)
+        {
+            int fPrefetch = runIndex ^ (round & 1);
+
+            auto start = std::chrono::steady_clock::now();
+
+            for (U64 key : keys)
+            {
+                if (fPrefetch)
+                {
+                    TRANSPOSITION_TABLE.prefetch(key);
+                }
+
+                // A chain of dependent multiplications stands in for the rest of makeMove
+                for (int step = 0; step < 64; step++)
+                {
+                    work = work * 6364136223846793005ULL + key;
+                }
+
+                hits += TRANSPOSITION_TABLE.probe(key, hashData);
+            }
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            bestSeconds[fPrefetch] = std::min(bestSeconds[fPrefetch], seconds);
+        }
+    }
+
+    cout << "Best of " << HASH_PREFETCH_ROUNDS << " alternating runs\n";
+    cout << "Without prefetch: " << std::fixed << std::setprecision(1) << bestSeconds[0] * 1e9 / numProbes << " ns per move\n";
+    cout << "With prefetch:    " << bestSeconds[1] * 1e9 / numProbes << " ns per move\n";
+    cout << "Gain: " << (1.0 - bestSeconds[1] / bestSeconds[0]) * 100.0 << "%\n";
+
+    // Print the accumulated values so the compiler cannot drop the loop
+    cout << "\n(checksum " << (work ^ hits) << ")\n\n";
+
+    TRANSPOSITION_TABLE.clear();
+}
+
+// Get the entry a stress test thread stores for the given key, so any reader can verify what it got back
+static int getStressTestScore(U64 hashKey)
+{
+    return (int)(hashKey & 0xffff) - 32768;
+}
+
+static int getStressTestDepth(U64 hashKey)
+{
+    return (hashKey >> 16) & 0x3f;
+}
+
+static int getStressTestFlag(U64 hashKey)
+{
+    return (hashKey >> 22) % 3;
+}
+
+static int getStressTestMove(U64 hashKey)
+{
+    return ((hashKey >> 24) & 0xffffff) | 1;
+}
+
+// Hammer the transposition table from many threads and return true if no torn entry was read
+bool stressTestTranspositionTable(int numThreads, int numOperations)
+{
+    // Many keys sharing a few buckets, so the threads constantly overwrite each other's entries
+    const int NUM_KEYS = 256;
+
+    cout << "\n    Transposition table stress test (" << numThreads << " threads, " << numOperations << " operations each)\n\n";
+
+    std::vector<U64> keys(NUM_KEYS);
+    std::mt19937_64 keyGenerator(NUM_KEYS);
+
+    for (U64 &key : keys)
+    {
+        // The bucket index comes from the high bits of the key, so small keys all land in the first buckets
+        key = keyGenerator() >> 20;
+    }
+
+    TRANSPOSITION_TABLE.clear();
+
+    std::atomic<U64> stores{0}, probes{0}, hits{0}, tornEntries{0};
+    std::vector<std::thread> workers;
+
+    for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+    {
+        workers.emplace_back([&, threadIndex]()
+                             {
+            std::mt19937_64 generator(threadIndex);
+            U64 threadStores = 0, threadProbes = 0, threadHits = 0, threadTornEntries = 0;
+
+            for (int operation = 0; operation < numOperations; operation++)
+            {
+                U64 hashKey = keys[generator() % NUM_KEYS];
+
+                // Half of the operations store, the other half probe
+                if (generator() & 1)
+                {
+                    TRANSPOSITION_TABLE.store(hashKey, getStressTestMove(hashKey), getStressTestScore(hashKey), getStressTestDepth(hashKey), getStressTestFlag(hashKey));
+                    threadStores++;
+                    continue;
+                }
+
+                U64 hashData;
+                threadProbes++;
+
+                if (TRANSPOSITION_TABLE.probe(hashKey, hashData))
+                {
+                    threadHits++;
+
+                    // A validated entry must hold exactly the data stored for its key
+                    if (getHashMove(hashData) != getStressTestMove(hashKey) ||
+                        getHashScore(hashData) != getStressTestScore(hashKey) ||
+                        getHashDepth(hashData) != getStressTestDepth(hashKey) ||
+                        getHashFlag(hashData) != getStressTestFlag(hashKey))
+                    {
+                        threadTornEntries++;
+                    }
+                }
+            }
+
+            stores += threadStores;
+            probes += threadProbes;
+            hits += threadHits;
+            tornEntries += threadTornEntries; });
+    }
+
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    TRANSPOSITION_TABLE.clear();
+
+    cout << "Stores: " << stores << '\n';
+    cout << "Probes: " << probes << '\n';
+    cout << "Validated hits: " << hits << '\n';
+    cout << "Torn entries returned: " << tornEntries << "\n\n";
+
+    return tornEntries == 0;
+}
+
+// Check that the move does not leave the king of the moving side attacked
+static bool isMoveLegal(Board &board, int move)
+{
+    UndoInfo undo;
+    board.makeMove(move, undo);
+
+    int kingSquareIndex = getLS1BIndex(board.getBitboards()[(board.getSideToMove() == white) ? blackKing : whiteKing]);
+    bool fLegal = !board.isSquareAttacked(kingSquareIndex, board.getSideToMove());
+
+    board.unmakeMove(move, undo);
+
+    return fLegal;
+}
+
+// Compare the generation types at every node of the tree below the board, returning the perft leaf count reached through the split generators
+static U64 verifyMoveGenerationNode(Board &node, int depth, const std::vector<int> &parentMoves, U64 &mismatches)
+{
+    if (depth == 0)
+    {
+        return 1ULL;
+    }
+
+    MoveList moves = node.generateMoves(allMoves);
+    MoveList captures = node.generateMoves(captureMoves);
+    MoveList quiets = node.generateMoves(quietMoves);
+
+    std::vector<int> allList(moves.getMoves(), moves.getMoves() + moves.getCount());
+    std::vector<int> splitList;
+
+    // The capture stream holds the captures and queen promotions, the quiet stream everything else
+    for (int moveIndex = 0; moveIndex < captures.getCount(); moveIndex++)
+    {
+        int move = captures.getMoves()[moveIndex];
+        mismatches += !isCapture(move) && getPromotedPiece(move) % 6 != queen;
+        splitList.push_back(move);
+    }
+
+    for (int moveIndex = 0; moveIndex < quiets.getCount(); moveIndex++)
+    {
+        int move = quiets.getMoves()[moveIndex];
+        mismatches += isCapture(move) || getPromotedPiece(move) % 6 == queen;
+        splitList.push_back(move);
+    }
+
+    std::sort(allList.begin(), allList.end());
+    std::sort(splitList.begin(), splitList.end());
+
+    // Together the two streams must be exactly the full move list
+    mismatches += allList != splitList;
+
+    // The evasions are the same legal moves, generated at once
+    MoveList evasions = node.generateMoves(evasionMoves);
+    std::vector<int> evasionList(evasions.getMoves(), evasions.getMoves() + evasions.getCount());
+    std::sort(evasionList.begin(), evasionList.end());
+
+    mismatches += evasionList != allList;
+
+    // The check of single moves used for the hash move must accept exactly the generated moves, tried on them, on the moves of the
+    // parent position and on every generated move with one bit of its encoding flipped
+    std::vector<int> candidates(parentMoves);
+
+    for (int move : allList)
+    {
+        candidates.push_back(move);
+
+        for (int bit = 0; bit < 24; bit++)
+        {
+            candidates.push_back(move ^ (1 << bit));
+        }
+    }
+
+    for (int move : candidates)
+    {
+        mismatches += node.isLegalMove(move) != std::binary_search(allList.begin(), allList.end(), move);
+    }
+
+    U64 leaves = 0ULL;
+
+    for (int move : splitList)
+    {
+        // Every generated move must be legal, while the perft count shows that no legal move is missing
+        mismatches += !isMoveLegal(node, move);
+
+        UndoInfo undo;
+        std::vector<U64> bitboards(node.getBitboards(), node.getBitboards() + 12);
+
+        node.makeMove(move, undo);
+        leaves += verifyMoveGenerationNode(node, depth - 1, allList, mismatches);
+        node.unmakeMove(move, undo);
+
+        // Taking the move back must put every piece back where it was
+        mismatches += !std::equal(bitboards.begin(), bitboards.end(), node.getBitboards());
+    }
+
+    return leaves;
+}
+
+// Check that the generated moves are legal and that the capture, quiet and evasion generators agree with the full generator and the known perft results
+bool verifyMoveGeneration(int depth)
+{
+    cout << "\n    Move generation check (depth " << depth << ")\n\n";
+    cout << std::setw(10) << "Position" << std::setw(14) << "Leaves" << std::setw(14) << "Expected"
+         << std::setw(12) << "Mismatches" << std::setw(12) << "Time (ms)" << '\n';
+
+    bool fPassed = true;
+
+    for (int positionIndex = 0; positionIndex < 4; positionIndex++)
+    {
+        U64 mismatches = 0ULL;
+
+        auto start = std::chrono::steady_clock::now();
+        Board board(BENCHMARK_POSITIONS_FEN[positionIndex]);
+        U64 leaves = verifyMoveGenerationNode(board, depth, std::vector<int>(), mismatches);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // The leaf count can only be checked for the depths with a known result
+        bool fKnownDepth = depth >= 1 && depth <= 4;
+        U64 expectedLeaves = fKnownDepth ? PERFT_RESULTS[positionIndex][depth - 1] : leaves;
+
+        fPassed = fPassed && mismatches == 0 && leaves == expectedLeaves;
+
+        cout << std::setw(10) << positionIndex + 1
+             << std::setw(14) << leaves
+             << std::setw(14) << (fKnownDepth ? std::to_string(expectedLeaves) : "-")
+             << std::setw(12) << mismatches
+             << std::setw(12) << (U64)(seconds * 1000) << '\n';
+    }
+
+    cout << '\n' << (fPassed ? "Passed" : "Failed") << "\n\n";
+
+    return fPassed;
+}
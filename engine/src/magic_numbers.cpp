@@ -1,4 +1,6 @@
 #include <cstring>
+#include <iomanip>
+#include <iostream>
 
 #include "magic_numbers.h"
 #include "bitboard_operations.h"
@@ -7,163 +9,6 @@
 #include "random.h"
 #include "const.h"
 
-// Dynamically generate bishop attack mask for a given occupancy and the square index
-U64 generateBishopAttacks(int squareIndex, const U64 &occupancy)
-{
-    U64 attacksBitboard = 0ULL;
-
-    int rank, file;
-
-    // Get the file and the rank from the square index
-    int targetRank = squareIndex / 8;
-    int targetFile = squareIndex % 8;
-
-    // Cast an attack ray in the positive file and positive rank direction
-    for (rank = targetRank + 1, file = targetFile + 1; rank < 8 && file < 8; rank++, file++)
-    {
-        // Set the bit on the attack bitboard
-        setBit(attacksBitboard, rank * 8 + file);
-
-        // Break out the loop if the piece is found at the current square index
-        if (getBit(occupancy, rank * 8 + file))
-        {
-            break;
-        }
-    }
-
-    // Cast an attack ray in the positive file and negative rank direction
-    for (rank = targetRank - 1, file = targetFile + 1; rank >= 0 && file < 8; rank--, file++)
-    {
-        // Set the bit on the attack bitboard
-        setBit(attacksBitboard, rank * 8 + file);
-
-        // Break out the loop if the piece is found at the current square index
-        if (getBit(occupancy, rank * 8 + file))
-        {
-            break;
-        }
-    }
-
-    // Cast an attack ray in the negative file and positive rank direction
-    for (rank = targetRank + 1, file = targetFile - 1; rank < 8 && file >= 0; rank++, file--)
-    {
-        // Set the bit on the attack bitboard
-        setBit(attacksBitboard, rank * 8 + file);
-
-        // Break out the loop if the piece is found at the current square index
-        if (getBit(occupancy, rank * 8 + file))
-        {
-            break;
-        }
-    }
-
-    // Cast an attack ray in the negative file and negative rank direction
-    for (rank = targetRank - 1, file = targetFile - 1; rank >= 0 && file >= 0; rank--, file--)
-    {
-        // Set the bit on the attack bitboard
-        setBit(attacksBitboard, rank * 8 + file);
-
-        // Break out the loop if the piece is found at the current square index
-        if (getBit(occupancy, rank * 8 + file))
-        {
-            break;
-        }
-    }
-
-    return attacksBitboard;
-}
-
-// Dynamically generate rook attack mask for a given occupancy and the square index
-U64 generateRookAttacks(int squareIndex, const U64 &occupancy)
-{
-
-    U64 attacksBitboard = 0ULL;
-
-    int rank, file;
-
-    // Get the file and the rank from the square index
-    int targetRank = squareIndex / 8;
-    int targetFile = squareIndex % 8;
-
-    // Cast an attack ray in the positive rank direction
-    for (rank = targetRank + 1; rank < 8; rank++)
-    {
-        // Set the bit on the attack bitboard
-        setBit(attacksBitboard, rank * 8 + targetFile);
-
-        // Break out the loop if the piece is found at the current square index
-        if (getBit(occupancy, rank * 8 + targetFile))
-        {
-            break;
-        }
-    }
-
-    // Cast an attack ray in the negative rank direction
-    for (rank = targetRank - 1; rank >= 0; rank--)
-    {
-        // Set the bit on the attack bitboard
-        setBit(attacksBitboard, rank * 8 + targetFile);
-
-        // Break out the loop if the piece is found at the current square index
-        if (getBit(occupancy, rank * 8 + targetFile))
-        {
-            break;
-        }
-    }
-
-    // Cast an attack ray in the positive file direction
-    for (file = targetFile + 1; file < 8; file++)
-    {
-        // Set the bit on the attack bitboard
-        setBit(attacksBitboard, targetRank * 8 + file);
-
-        // Break out the loop if the piece is found at the current square index
-        if (getBit(occupancy, targetRank * 8 + file))
-        {
-            break;
-        }
-    }
-
-    // Cast an attack ray in the negative file direction
-    for (file = targetFile - 1; file >= 0; file--)
-    {
-        // Set the bit on the attack bitboard
-        setBit(attacksBitboard, targetRank * 8 + file);
-
-        // Break out the loop if the piece is found at the current square index
-        if (getBit(occupancy, targetRank * 8 + file))
-        {
-            break;
-        }
-    }
-
-    return attacksBitboard;
-}
-
-// Generate the occupancy bitboards from the given occupancy index
-U64 getOccupancyFromIndex(int occupancyIndex, int relevantBits, U64 attackMask)
-{
-    U64 bitboard = 0ULL;
-
-    // Loop over the relevant bits of the attack mask
-    for (int currentBit = 0; currentBit < relevantBits; currentBit++)
-    {
-        // Get the LS1B index
-        int squareIndex = getLS1BIndex(attackMask);
-
-        // Pop the LS1B from the bitboard
-        popBit(attackMask, squareIndex);
-        // If the occupancy index includes the current bit
-        if (occupancyIndex & (1 << currentBit))
-        {
-            // Set the bit on the occupancy bitboard
-            setBit(bitboard, squareIndex);
-        }
-    }
-
-    return bitboard;
-}
-
 // Find a magic number for the given sliding piece and a given
 U64 findMagicNumber(int squareIndex, int relevantBits, bool fBishop)
 {
@@ -191,9 +36,6 @@ U64 findMagicNumber(int squareIndex, int relevantBits, bool fBishop)
         attacks[index] = fBishop ? generateBishopAttacks(squareIndex, occupancies[index]) : generateRookAttacks(squareIndex, occupancies[index]);
     }
 
-    // Seed the pseudo-random number generator
-    seedRandom();
-
     // Trial and error method needs a lot of repetitions, values from 10^7 to 10^9 should be used
     for (int i = 0; i < 100000000; i++)
     {
@@ -243,4 +85,55 @@ U64 findMagicNumber(int squareIndex, int relevantBits, bool fBishop)
 
     // Return an empty bitboard
     return 0ULL;
-}
\ No newline at end of file
+}
+
+// Check that the magic number maps every occupancy of the attack mask to an index holding the same attacks
+bool isMagicNumberValid(int squareIndex, int relevantBits, bool fBishop, U64 magicNumber)
+{
+    U64 usedAttacks[4096];
+    U64 attackMask = fBishop ? maskBishopAttacks(squareIndex) : maskRookAttacks(squareIndex);
+    int maxOccupancyIndex = 1 << relevantBits;
+
+    memset(usedAttacks, 0, sizeof(usedAttacks));
+
+    for (int index = 0; index < maxOccupancyIndex; index++)
+    {
+        U64 occupancy = getOccupancyFromIndex(index, relevantBits, attackMask);
+        U64 attacks = fBishop ? generateBishopAttacks(squareIndex, occupancy) : generateRookAttacks(squareIndex, occupancy);
+        int magicIndex = (int)((occupancy * magicNumber) >> (64 - relevantBits));
+
+        // A slider always attacks at least one square, so an empty entry has no mapping yet
+        if (usedAttacks[magicIndex] == 0ULL)
+        {
+            usedAttacks[magicIndex] = attacks;
+        }
+        else if (usedAttacks[magicIndex] != attacks)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Search for the magic numbers of all of the squares and print them as the constant arrays of const.h
+void printMagicNumbers()
+{
+    const char *ARRAY_NAMES[2] = {"ROOK_MAGIC_NUMBERS", "BISHOP_MAGIC_NUMBERS"};
+
+    for (int fBishop = 1; fBishop >= 0; fBishop--)
+    {
+        std::cout << "constexpr U64 " << ARRAY_NAMES[fBishop] << "[64] = {\n";
+
+        for (int squareIndex = 0; squareIndex < 64; squareIndex++)
+        {
+            int relevantBits = fBishop ? BISHOP_RELEVANT_BITS[squareIndex] : ROOK_RELEVANT_BITS[squareIndex];
+            U64 magicNumber = findMagicNumber(squareIndex, relevantBits, fBishop);
+
+            std::cout << ((squareIndex % 4 == 0) ? "    " : " ") << "0x" << std::hex << std::uppercase << std::setfill('0') << std::setw(16) << magicNumber << std::dec << "ULL,"
+                      << ((squareIndex % 4 == 3) ? "\n" : "");
+        }
+
+        std::cout << "};\n\n";
+    }
+}
@@ -1,27 +1,56 @@
 #include <emscripten.h>
 #include <cctype>
+#include <chrono>
 #include <cstring>
 #include <string>
 
 #include "globals.h"
 #include "random.h"
-#include "Position.h"
+#include "SearchThreads.h"
 #include "move_encoding.h"
 #include "const.h"
 
 static bool initialised = false;
+static double startupMilliseconds = 0.0;
+
+// The browser build has no shared memory threads, so the search runs on the main thread only.
+// The searcher lives as long as the module, so its pawn hash table is kept between moves like the transposition table.
+static SearchThreads searchThreads(1);
 
 static void init()
 {
     if (initialised) return;
+    auto start = std::chrono::steady_clock::now();
     seedRandom();
     generateKeys();
-    generateEvaluationMasks();
+    startupMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
     initialised = true;
 }
 
 extern "C"
 {
+    // Reallocate the transposition table with the given size in megabytes
+    EMSCRIPTEN_KEEPALIVE
+    void setHashSize(int megabytes)
+    {
+        TRANSPOSITION_TABLE.resize(megabytes);
+    }
+
+    // Forget everything learnt in the previous game
+    EMSCRIPTEN_KEEPALIVE
+    void clearHash()
+    {
+        TRANSPOSITION_TABLE.clear();
+    }
+
+    // Get the milliseconds the one-time initialisation of the module took, the lookup tables being generated at compile time
+    EMSCRIPTEN_KEEPALIVE
+    double measureStartupTime()
+    {
+        init();
+        return startupMilliseconds;
+    }
+
     // Returns the best move as a UCI string
     // The caller must not free the returned pointer as it points to a static buffer.
     EMSCRIPTEN_KEEPALIVE
@@ -29,28 +58,7 @@ extern "C"
     {
         init();
 
-        std::string fenStr(fen);
-        Position position(fenStr);
-        position.resetSearchVariables();
-
-        int alpha = -INF, beta = INF;
-
-        for (int currentDepth = 1; currentDepth <= depth; currentDepth++)
-        {
-            int score = position.negamax(alpha, beta, currentDepth);
-
-            if ((score <= alpha) || (score >= beta))
-            {
-                alpha = -INF;
-                beta = INF;
-                continue;
-            }
-
-            alpha = score + ASPIRATION_WINDOW;
-            beta = score - ASPIRATION_WINDOW;
-        }
-
-        int move = position.getBestMove();
+        int move = searchThreads.search(std::string(fen), depth, false);
         static char result[6];
 
         if (!move)